@@ -0,0 +1,95 @@
+/**
+ * @file md5bench.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <string>
+#include <iostream>
+#include "md5.hpp"
+
+/// @note Symbols are drawn at random between these lengths, about what a lexicon holds.
+static const int MD5BENCH_MIN_LENGTH = 2;
+static const int MD5BENCH_MAX_LENGTH = 16;
+
+static const double secondsSince(const clock_t p_strt) {
+    return (double) (clock() - p_strt) / CLOCKS_PER_SEC;
+}
+
+/**
+ * Hashes N word-length symbols once through MD5 one at a time and once
+ * through MD5::digestMany(), then checks both produced the same digests.
+ *
+ * Usage: wntrdata-md5bench [N]
+ */
+int main(int p_argc, char** p_argv) {
+    const int l_cnt = p_argc > 1 ? atoi(p_argv[1]) : 1000000;
+    if (l_cnt <= 0) {
+        std::cerr << "usage: " << p_argv[0] << " [symbols]" << std::endl;
+        return 2;
+    }
+
+    srand(42);
+    std::vector<std::string> l_syms(l_cnt);
+    for (int i = 0; i < l_cnt; i++) {
+        const int l_len = MD5BENCH_MIN_LENGTH + rand() % (MD5BENCH_MAX_LENGTH - MD5BENCH_MIN_LENGTH + 1);
+        for (int j = 0; j < l_len; j++)
+            l_syms[i] += (char) ('a' + rand() % 26);
+    }
+
+    std::vector<unsigned char> l_sclr(l_cnt * 16), l_mny(l_cnt * 16);
+
+    clock_t l_strt = clock();
+    for (int i = 0; i < l_cnt; i++)
+        MD5(l_syms[i]).rawdigest(&l_sclr[i * 16]);
+
+    const double l_sclrSecs = secondsSince(l_strt);
+
+    l_strt = clock();
+    MD5::digestMany(&l_syms[0], l_cnt, (unsigned char (*)[16]) &l_mny[0]);
+    const double l_mnySecs = secondsSince(l_strt);
+
+    int l_msmtchs = 0;
+    for (int i = 0; i < l_cnt; i++) {
+        if (memcmp(&l_sclr[i * 16], &l_mny[i * 16], 16) != 0) {
+            if (l_msmtchs++ < 8)
+                std::cerr << "mismatch for \"" << l_syms[i] << "\"" << std::endl;
+        }
+    }
+
+    std::cout << l_cnt << " symbols, " << MD5::lanes() << " lane(s)" << std::endl
+              << "  scalar:     " << l_sclrSecs << " s" << std::endl
+              << "  digestMany: " << l_mnySecs << " s";
+    if (l_mnySecs > 0)
+        std::cout << " (" << l_sclrSecs / l_mnySecs << "x)";
+
+    std::cout << std::endl;
+
+    if (l_msmtchs > 0) {
+        std::cerr << l_msmtchs << " digest(s) differ." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -29,9 +29,42 @@
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QVariant>
+#include <qjson/parser.h>
+#include <qjson/serializer.h>
+#include <qjson/qobjecthelper.h>
 
 namespace Wintermute {
 namespace Data {
+
+/**
+ * @brief A D-Bus call whose reply was delayed; it's answered once its future's finished.
+ * @class PendingCall adaptors.cpp "src/adaptors.cpp"
+ */
+class PendingCall {
+private:
+    QDBusConnection m_cnx;
+    QDBusMessage m_msg;
+
+public:
+    PendingCall(const QDBusConnection& p_cnx, const QDBusMessage& p_msg) : m_cnx(p_cnx), m_msg(p_msg) { }
+
+    void reply(const QVariant& p_rslt) const {
+        m_cnx.send(m_msg.createReply(p_rslt));
+    }
+};
+
+static void replyNode(const Lexical::Data& p_dt, const PendingCall& p_call) {
+    p_call.reply(p_dt.toString());
+}
+
+static void replyExists(const bool& p_exsts, const PendingCall& p_call) {
+    p_call.reply(p_exsts);
+}
+
+static void replyChain(const Rules::Chain& p_chn, const PendingCall& p_call) {
+    p_call.reply(p_chn.toString());
+}
+
 NodeAdaptor::NodeAdaptor()
         : QDBusAbstractAdaptor(NodeManager::instance()) {
     // constructor
@@ -40,7 +73,18 @@ NodeAdaptor::NodeAdaptor()
 
 NodeAdaptor::~NodeAdaptor() { }
 
+NodeManager* NodeAdaptor::manager() const {
+    return static_cast<NodeManager*>(parent());
+}
+
+/// @note Outside of a D-Bus call there's no reply to delay, so it's answered right away.
 bool NodeAdaptor::exists(QString in0) {
+    if (manager()->calledFromDBus()) {
+        manager()->setDelayedReply(true);
+        Async::then(NodeManager::instance()->existsAsync(Lexical::Data::fromString(in0)), &replyExists, PendingCall(manager()->connection(), manager()->message()));
+        return false;
+    }
+
     return NodeManager::instance()->exists(Lexical::Data::fromString(in0));
 }
 
@@ -64,17 +108,104 @@ void NodeAdaptor::quit() {
 }
 
 QString NodeAdaptor::read(QString in0) {
+    if (manager()->calledFromDBus()) {
+        manager()->setDelayedReply(true);
+        Async::then(NodeManager::instance()->readAsync(Lexical::Data::fromString(in0)), &replyNode, PendingCall(manager()->connection(), manager()->message()));
+        return QString();
+    }
+
     Lexical::Data out0;
     QMetaObject::invokeMethod(parent(), "read", Q_RETURN_ARG(Lexical::Data, out0), Q_ARG(Lexical::Data, Lexical::Data::fromString(in0)));
     return out0.toString();
 }
 
+/// @note in1 is the greatest edit distance a miss may be approximated within before falling back to the pseudo node.
+QString NodeAdaptor::readApproximate(QString in0, int in1) {
+    Lexical::Data l_dt = Lexical::Data::fromString(in0);
+    return NodeManager::instance()->read(l_dt, qMax(in1, 0)).toString();
+}
+
 QString NodeAdaptor::write(QString in0) {
+    if (manager()->calledFromDBus()) {
+        manager()->setDelayedReply(true);
+        Async::then(NodeManager::instance()->writeAsync(Lexical::Data::fromString(in0)), &replyNode, PendingCall(manager()->connection(), manager()->message()));
+        return QString();
+    }
+
     Lexical::Data out0;
     QMetaObject::invokeMethod(parent(), "write", Q_RETURN_ARG(Lexical::Data, out0), Q_ARG(Lexical::Data, Lexical::Data::fromString(in0)));
     return out0.toString();
 }
 
+/// @note in0 is a JSON array of nodes; in1 is a Lexical::Storage::Durability.
+int NodeAdaptor::writeBatch(QString in0, int in1) {
+    QJson::Parser l_parser;
+    const QVariantList l_lst = l_parser.parse(in0.toUtf8()).toList();
+
+    QList<Lexical::Data> l_nodes;
+    foreach (const QVariant l_vrnt, l_lst) {
+        Lexical::Data l_dt;
+        QJson::QObjectHelper::qvariant2qobject(l_vrnt.toMap(), &l_dt);
+        l_nodes << l_dt;
+    }
+
+    return NodeManager::instance()->writeBatch(l_nodes, in1);
+}
+
+QString NodeAdaptor::statistics() {
+    QJson::Serializer l_serializer;
+    return QString(l_serializer.serialize(NodeManager::instance()->statistics()));
+}
+
+/// @note The reply holds the page's IDs under "Nodes" and the cursor of the next page under "Cursor" (empty after the last page).
+QString NodeAdaptor::scanNodes(QString in0, QString in1, int in2) {
+    const int l_lmt = qBound(1, in2, 65536);
+    const QStringList l_ids = NodeManager::instance()->scanNodes(in0, in1, l_lmt);
+
+    QVariantMap l_pg;
+    l_pg["Nodes"] = l_ids;
+    l_pg["Cursor"] = (l_ids.count() < l_lmt) ? QString() : l_ids.last();
+
+    QJson::Serializer l_serializer;
+    return QString(l_serializer.serialize(l_pg));
+}
+
+/// @note The reply maps each symbol found (in lower case) to the ID of its node.
+QString NodeAdaptor::prefixSearch(QString in0, QString in1, int in2) {
+    QJson::Serializer l_serializer;
+    return QString(l_serializer.serialize(NodeManager::instance()->prefixSearch(in0, in1, qBound(1, in2, 65536))));
+}
+
+/// @note The reply lists the symbols found, nearest first, each with its "Symbol", "Id" and "Distance".
+QString NodeAdaptor::fuzzySearch(QString in0, QString in1, int in2, int in3) {
+    QJson::Serializer l_serializer;
+    return QString(l_serializer.serialize(NodeManager::instance()->fuzzySearch(in0, in1, qMax(in2, 0), qBound(1, in3, 1024))));
+}
+
+/// @note in2 treats in1 as a prefix of link codes; the reply maps each code matched to the IDs of its nodes.
+QString NodeAdaptor::linkSearch(QString in0, QString in1, bool in2, int in3) {
+    QJson::Serializer l_serializer;
+    return QString(l_serializer.serialize(NodeManager::instance()->linkSearch(in0, in1, in2, qBound(1, in3, 65536))));
+}
+
+/// @note The reply maps each link code starting with in1 to the number of nodes carrying it.
+QString NodeAdaptor::linkCodes(QString in0, QString in1) {
+    QJson::Serializer l_serializer;
+    return QString(l_serializer.serialize(NodeManager::instance()->linkCodes(in0, in1)));
+}
+
+/// @note The reply lists the locales unloaded for being idle at least in0 seconds; meant for a memory monitor to call.
+QString NodeAdaptor::unloadIdle(int in0) {
+    QJson::Serializer l_serializer;
+    return QString(l_serializer.serialize(NodeManager::instance()->unloadIdle(qMax(in0, 0))));
+}
+
+/// @note The reply maps each symbol found (in lower case) to the ID of its node.
+QString NodeAdaptor::rangeSearch(QString in0, QString in1, QString in2, int in3) {
+    QJson::Serializer l_serializer;
+    return QString(l_serializer.serialize(NodeManager::instance()->rangeSearch(in0, in1, in2, qBound(1, in3, 65536))));
+}
+
 RuleAdaptor::RuleAdaptor()
         : QDBusAbstractAdaptor(RuleManager::instance()) {
     setAutoRelaySignals(true);
@@ -82,6 +213,10 @@ RuleAdaptor::RuleAdaptor()
 
 RuleAdaptor::~RuleAdaptor() { }
 
+RuleManager* RuleAdaptor::manager() const {
+    return static_cast<RuleManager*>(parent());
+}
+
 bool RuleAdaptor::exists(const QString &in0, const QString &in1) {
     bool out0;
     QMetaObject::invokeMethod(parent(), "exists", Q_RETURN_ARG(bool, out0), Q_ARG(QString, in0), Q_ARG(QString, in1));
@@ -93,6 +228,12 @@ void RuleAdaptor::quit() {
 }
 
 QString RuleAdaptor::read(QString in0) {
+    if (manager()->calledFromDBus()) {
+        manager()->setDelayedReply(true);
+        Async::then(RuleManager::instance()->readAsync(Rules::Chain::fromString(in0)), &replyChain, PendingCall(manager()->connection(), manager()->message()));
+        return QString();
+    }
+
     Rules::Chain l_chn = Rules::Chain::fromString(in0);
     RuleManager::instance()->read(l_chn);
     return l_chn.toString();
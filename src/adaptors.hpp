@@ -32,6 +32,10 @@ using namespace Wintermute::Data::Linguistics;
 
 namespace Wintermute {
 namespace Data {
+struct NodeManager;
+struct RuleManager;
+
+/// @note read, write and exists are answered with delayed replies, so a slow disk doesn't hold up other callers.
 class NodeAdaptor: public QDBusAbstractAdaptor {
     Q_OBJECT
     Q_CLASSINFO("D-Bus Interface", "org.thesii.Wintermute.Data.Nodes")
@@ -52,6 +56,11 @@ class NodeAdaptor: public QDBusAbstractAdaptor {
                 "      <arg direction=\"out\" type=\"s\"/>\n"
                 "      <arg direction=\"in\" type=\"s\"/>\n"
                 "    </method>\n"
+                "    <method name=\"writeBatch\">\n"
+                "      <arg direction=\"out\" type=\"i\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"i\"/>\n"
+                "    </method>\n"
                 "    <method name=\"pseudo\">\n"
                 "      <arg direction=\"out\" type=\"s\"/>\n"
                 "      <arg direction=\"in\" type=\"s\"/>\n"
@@ -64,12 +73,65 @@ class NodeAdaptor: public QDBusAbstractAdaptor {
                 "      <arg direction=\"out\" type=\"b\"/>\n"
                 "      <arg direction=\"in\" type=\"s\"/>\n"
                 "    </method>\n"
+                "    <method name=\"statistics\">\n"
+                "      <arg direction=\"out\" type=\"s\"/>\n"
+                "    </method>\n"
+                "    <method name=\"scanNodes\">\n"
+                "      <arg direction=\"out\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"i\"/>\n"
+                "    </method>\n"
+                "    <method name=\"prefixSearch\">\n"
+                "      <arg direction=\"out\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"i\"/>\n"
+                "    </method>\n"
+                "    <method name=\"readApproximate\">\n"
+                "      <arg direction=\"out\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"i\"/>\n"
+                "    </method>\n"
+                "    <method name=\"fuzzySearch\">\n"
+                "      <arg direction=\"out\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"i\"/>\n"
+                "      <arg direction=\"in\" type=\"i\"/>\n"
+                "    </method>\n"
+                "    <method name=\"linkSearch\">\n"
+                "      <arg direction=\"out\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"b\"/>\n"
+                "      <arg direction=\"in\" type=\"i\"/>\n"
+                "    </method>\n"
+                "    <method name=\"linkCodes\">\n"
+                "      <arg direction=\"out\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "    </method>\n"
+                "    <method name=\"unloadIdle\">\n"
+                "      <arg direction=\"out\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"i\"/>\n"
+                "    </method>\n"
+                "    <method name=\"rangeSearch\">\n"
+                "      <arg direction=\"out\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"s\"/>\n"
+                "      <arg direction=\"in\" type=\"i\"/>\n"
+                "    </method>\n"
                 "  </interface>\n"
                 "")
 public:
     NodeAdaptor();
     virtual ~NodeAdaptor();
 
+private:
+    NodeManager* manager() const;
+
 public: // PROPERTIES
 public Q_SLOTS: // METHODS
     bool exists(QString in0);
@@ -79,10 +141,21 @@ public Q_SLOTS: // METHODS
     void quit();
     QString read(QString in0);
     QString write(QString in0);
+    int writeBatch(QString in0, int in1);
+    QString statistics();
+    QString scanNodes(QString in0, QString in1, int in2);
+    QString prefixSearch(QString in0, QString in1, int in2);
+    QString rangeSearch(QString in0, QString in1, QString in2, int in3);
+    QString readApproximate(QString in0, int in1);
+    QString fuzzySearch(QString in0, QString in1, int in2, int in3);
+    QString linkSearch(QString in0, QString in1, bool in2, int in3);
+    QString linkCodes(QString in0, QString in1);
+    QString unloadIdle(int in0);
 Q_SIGNALS: // SIGNALS
     void nodeCreated(const QString &in0);
 };
 
+/// @note read is answered with a delayed reply, so a slow disk doesn't hold up other callers.
 class RuleAdaptor: public QDBusAbstractAdaptor {
     Q_OBJECT
     Q_CLASSINFO("D-Bus Interface", "org.thesii.Wintermute.Data.Rules")
@@ -111,6 +184,9 @@ public:
     RuleAdaptor();
     virtual ~RuleAdaptor();
 
+private:
+    RuleManager* manager() const;
+
 public: // PROPERTIES
 public Q_SLOTS: // METHODS
     bool exists(const QString &in0, const QString &in1);
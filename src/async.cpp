@@ -0,0 +1,59 @@
+/**
+ * @file async.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include "config.hpp"
+#include "async.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+
+/**
+ * @brief The pool behind Async::pool(), sized once it's made.
+ * @class AsyncPool async.cpp "src/async.cpp"
+ */
+class AsyncPool : public QThreadPool {
+public:
+    AsyncPool() : QThreadPool() {
+        setMaxThreadCount(qMax(WNTRDATA_IO_THREADS, 1));
+    }
+};
+
+static AsyncPool s_pool;
+
+QThreadPool* Async::pool() {
+    return &s_pool;
+}
+
+Continuing::Continuing() : QObject() { }
+
+Continuing::~Continuing() { }
+
+void Continuing::finish() {
+    resume();
+    deleteLater();
+}
+
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,215 @@
+/**
+ * @file async.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef ASYNC_HPP
+#define ASYNC_HPP
+
+#include <QObject>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QFutureWatcher>
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+struct Async;
+struct Continuing;
+
+/**
+ * @brief A unit of work run on the I/O pool, reporting its result through a QFuture.
+ *
+ * The future's started as soon as the task's made, so waiting on it
+ * before the pool gets around to the task doesn't return early.
+ *
+ * @class AsyncTask async.hpp "src/async.hpp"
+ */
+template<typename T>
+class AsyncTask : public QRunnable {
+private:
+    QFutureInterface<T> m_ftr;
+
+protected:
+    /**
+     * @brief Does the work of the task, on the pool.
+     * @fn call
+     */
+    virtual const T call() = 0;
+
+public:
+    AsyncTask() : QRunnable(), m_ftr() {
+        m_ftr.reportStarted();
+    }
+
+    virtual ~AsyncTask() { }
+
+    const QFuture<T> future() {
+        return m_ftr.future();
+    }
+
+    /// @note A task canceled before it's run reports no result.
+    virtual void run() {
+        if (!m_ftr.isCanceled()) {
+            const T l_rslt = call();
+            m_ftr.reportResult(l_rslt);
+        }
+
+        m_ftr.reportFinished();
+    }
+};
+
+/**
+ * @brief An AsyncTask that calls a function with a single argument.
+ * @class AsyncCall async.hpp "src/async.hpp"
+ */
+template<typename T, typename A>
+class AsyncCall : public AsyncTask<T> {
+public:
+    typedef const T (*Function)(const A&);
+
+private:
+    const Function m_fn;
+    const A m_arg;
+
+protected:
+    virtual const T call() {
+        return m_fn(m_arg);
+    }
+
+public:
+    AsyncCall(const Function p_fn, const A& p_arg) : AsyncTask<T>(), m_fn(p_fn), m_arg(p_arg) { }
+};
+
+/**
+ * @brief The part of a continuation Qt's meta-object system can see; it
+ *        resumes once the watched future's finished, then deletes itself.
+ * @class Continuing async.hpp "src/async.hpp"
+ */
+class Continuing : public QObject {
+    Q_OBJECT
+
+protected:
+    Continuing();
+
+    /**
+     * @brief Hands the finished future's result on.
+     * @fn resume
+     */
+    virtual void resume() = 0;
+
+protected slots:
+    void finish();
+
+public:
+    virtual ~Continuing();
+};
+
+/**
+ * @brief Calls a function with the result of a future once it's finished,
+ *        along with a context of the caller's choosing.
+ * @class Continuation async.hpp "src/async.hpp"
+ */
+template<typename T, typename C>
+class Continuation : public Continuing {
+public:
+    typedef void (*Function)(const T&, const C&);
+
+private:
+    QFutureWatcher<T> m_wtchr;
+    const Function m_fn;
+    const C m_ctx;
+
+protected:
+    /// @note A future that was canceled (and so holds no result) hands on a default T.
+    virtual void resume() {
+        m_fn(m_wtchr.future().resultCount() > 0 ? m_wtchr.result() : T(), m_ctx);
+    }
+
+public:
+    Continuation(const QFuture<T>& p_ftr, const Function p_fn, const C& p_ctx) : Continuing(), m_wtchr(), m_fn(p_fn), m_ctx(p_ctx) {
+        connect(&m_wtchr, SIGNAL(finished()), this, SLOT(finish()));
+        m_wtchr.setFuture(p_ftr);
+    }
+};
+
+/**
+ * @brief Runs storage I/O off the calling thread.
+ *
+ * Lexical and rule lookups run on a pool of their own, sized by
+ * WNTRDATA_IO_THREADS, so a slow disk never starves Qt's global pool
+ * (or the lexical cache's probe pool, which lookups wait on in turn).
+ *
+ * @class Async async.hpp "src/async.hpp"
+ */
+class Async {
+public:
+    /**
+     * @brief Obtains the pool I/O is run on.
+     * @fn pool
+     */
+    static QThreadPool* pool();
+
+    /**
+     * @brief Queues a task on the I/O pool; the pool owns it from here on.
+     * @fn start
+     * @param p_tsk The task in question.
+     * @return The future the task reports to.
+     */
+    template<typename T>
+    static const QFuture<T> start(AsyncTask<T>* p_tsk) {
+        const QFuture<T> l_ftr = p_tsk->future();
+        pool()->start(p_tsk);
+        return l_ftr;
+    }
+
+    /**
+     * @brief Calls a function on the I/O pool.
+     * @fn call
+     * @param p_fn The function in question.
+     * @param p_arg The argument to call it with; it's copied.
+     */
+    template<typename T, typename A>
+    static const QFuture<T> call(const T (*p_fn)(const A&), const A& p_arg) {
+        return start(new AsyncCall<T, A>(p_fn, p_arg));
+    }
+
+    /**
+     * @brief Continues with a function once a future's finished.
+     * @fn then
+     * @param p_ftr The future in question.
+     * @param p_fn The function to call with its result and p_ctx.
+     * @param p_ctx Whatever p_fn needs besides the result; it's copied.
+     * @note p_fn's called on the thread calling this, so that thread needs a running event loop.
+     */
+    template<typename T, typename C>
+    static void then(const QFuture<T>& p_ftr, void (*p_fn)(const T&, const C&), const C& p_ctx) {
+        new Continuation<T, C>(p_ftr, p_fn, p_ctx);
+    }
+};
+
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,89 @@
+/**
+ * @file atom.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+
+#include <QReadLocker>
+#include <QWriteLocker>
+#include "atom.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+
+QHash<QString, Atom> Atoms::s_atms;
+QVector<QString> Atoms::s_strs(1);
+QReadWriteLock Atoms::s_lck;
+
+const Atom Atoms::intern(const QString& p_str) {
+    if (p_str.isEmpty())
+        return 0;
+
+    {
+        QReadLocker l_lck(&s_lck);
+        const QHash<QString, Atom>::ConstIterator l_itr = s_atms.constFind(p_str);
+        if (l_itr != s_atms.constEnd())
+            return l_itr.value();
+    }
+
+    // Another thread may have interned it between the two locks.
+    QWriteLocker l_lck(&s_lck);
+    const QHash<QString, Atom>::ConstIterator l_itr = s_atms.constFind(p_str);
+    if (l_itr != s_atms.constEnd())
+        return l_itr.value();
+
+    const Atom l_atm = (Atom) s_strs.count();
+    s_strs.append(p_str);
+    s_atms.insert(p_str, l_atm);
+    return l_atm;
+}
+
+const bool Atoms::find(const QString& p_str, Atom& p_atm) {
+    if (p_str.isEmpty()) {
+        p_atm = 0;
+        return true;
+    }
+
+    QReadLocker l_lck(&s_lck);
+    const QHash<QString, Atom>::ConstIterator l_itr = s_atms.constFind(p_str);
+    if (l_itr == s_atms.constEnd())
+        return false;
+
+    p_atm = l_itr.value();
+    return true;
+}
+
+const QString Atoms::resolve(const Atom p_atm) {
+    QReadLocker l_lck(&s_lck);
+    return p_atm < (Atom) s_strs.count() ? s_strs.at(p_atm) : QString();
+}
+
+const int Atoms::count() {
+    QReadLocker l_lck(&s_lck);
+    return s_strs.count() - 1;
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
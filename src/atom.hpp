@@ -0,0 +1,101 @@
+/**
+ * @file atom.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+
+#ifndef ATOM_HPP
+#define ATOM_HPP
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QReadWriteLock>
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct Atoms;
+
+/**
+ * @brief A handle to an interned string.
+ *
+ * Handles are only meaningful within the process that interned them;
+ * they're never written to disk nor sent over D-Bus. The null handle
+ * stands for the empty string.
+ */
+typedef quint32 Atom;
+
+/**
+ * @brief The process-wide table of interned strings.
+ *
+ * Locales, flag GUIDs and link codes repeat across every node of the
+ * lexicon, so the nodes hold an Atom for each of them and the text is
+ * kept here once. Strings are never dropped from the table; the set of
+ * distinct locales, GUIDs and links is small and bounded by the lexicon.
+ *
+ * @class Atoms atom.hpp "src/atom.hpp"
+ */
+class Atoms {
+private:
+    static QHash<QString, Atom> s_atms;
+    static QVector<QString> s_strs;
+    static QReadWriteLock s_lck;
+
+public:
+    /**
+     * @brief Interns a string.
+     * @fn intern
+     * @param p_str The string in question.
+     * @return The handle of the string; the same one for every equal string.
+     */
+    static const Atom intern(const QString& );
+
+    /**
+     * @brief Finds the handle of a string without interning it.
+     * @fn find
+     * @param p_str The string in question.
+     * @param p_atm The handle to fill.
+     * @return true if the string's been interned.
+     */
+    static const bool find(const QString&, Atom& );
+
+    /**
+     * @brief Obtains the string behind a handle.
+     * @fn resolve
+     * @param p_atm The handle in question.
+     */
+    static const QString resolve(const Atom );
+
+    /**
+     * @brief Obtains the number of strings interned.
+     * @fn count
+     */
+    static const int count();
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
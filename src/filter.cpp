@@ -0,0 +1,122 @@
+/**
+ * @file filter.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <cmath>
+#include "filter.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+
+static inline quint64 mix(quint64 p_val) {
+    p_val ^= p_val >> 33;
+    p_val *= Q_UINT64_C(0xff51afd7ed558ccd);
+    p_val ^= p_val >> 33;
+    p_val *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    p_val ^= p_val >> 33;
+    return p_val;
+}
+
+BloomFilter::BloomFilter() : m_bits(), m_nbits(0), m_nhsh(0), m_cnt(0) { }
+
+BloomFilter::BloomFilter(const int p_cap, const double p_fpr) : m_bits(), m_nbits(0), m_nhsh(0), m_cnt(0) {
+    const double l_cap = (double) qMax(p_cap, 1);
+    const double l_ln2 = std::log(2.0);
+    const double l_bits = -(l_cap * std::log(p_fpr)) / (l_ln2 * l_ln2);
+
+    m_nbits = (quint32) qMax(64.0, std::ceil(l_bits));
+    m_nhsh = (quint32) qBound(1.0, std::floor(((double) m_nbits / l_cap) * l_ln2 + 0.5), 16.0);
+    m_bits.fill(0, (m_nbits + 63) / 64);
+}
+
+/// @note Kirsch-Mitzenmacher double hashing; the ID's a digest already, so its halves only need mixing.
+void BloomFilter::hash(const NodeId& p_id, quint64& p_h1, quint64& p_h2) {
+    p_h1 = mix(p_id.m_hi);
+    p_h2 = mix(p_id.m_lo ^ Q_UINT64_C(0x9e3779b97f4a7c15)) | 1;
+}
+
+void BloomFilter::insert(const NodeId& p_id) {
+    if (isNull())
+        return;
+
+    quint64 l_h1, l_h2;
+    hash(p_id, l_h1, l_h2);
+
+    bool l_new = false;
+    for (quint32 i = 0; i < m_nhsh; i++) {
+        const quint32 l_bit = (quint32) ((l_h1 + (i * l_h2)) % m_nbits);
+        const quint64 l_mask = Q_UINT64_C(1) << (l_bit % 64);
+        l_new |= !(m_bits.at(l_bit / 64) & l_mask);
+        m_bits[l_bit / 64] |= l_mask;
+    }
+
+    // Rewrites insert IDs that are already held; counting them would overstate the false-positive rate.
+    if (l_new)
+        m_cnt++;
+}
+
+const bool BloomFilter::mightContain(const NodeId& p_id) const {
+    if (isNull())
+        return true;
+
+    quint64 l_h1, l_h2;
+    hash(p_id, l_h1, l_h2);
+
+    for (quint32 i = 0; i < m_nhsh; i++) {
+        const quint32 l_bit = (quint32) ((l_h1 + (i * l_h2)) % m_nbits);
+        if (!(m_bits.at(l_bit / 64) & (Q_UINT64_C(1) << (l_bit % 64))))
+            return false;
+    }
+
+    return true;
+}
+
+const bool BloomFilter::isNull() const {
+    return m_nbits == 0;
+}
+
+const int BloomFilter::count() const {
+    return m_cnt;
+}
+
+const int BloomFilter::bits() const {
+    return (int) m_nbits;
+}
+
+const int BloomFilter::hashes() const {
+    return (int) m_nhsh;
+}
+
+const double BloomFilter::falsePositiveRate() const {
+    if (isNull())
+        return 1.0;
+
+    const double l_fill = 1.0 - std::exp(-((double) m_nhsh * (double) m_cnt) / (double) m_nbits);
+    return std::pow(l_fill, (double) m_nhsh);
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
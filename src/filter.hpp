@@ -0,0 +1,122 @@
+/**
+ * @file filter.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef FILTER_HPP
+#define FILTER_HPP
+
+#include <QString>
+#include <QVector>
+#include "node.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct BloomFilter;
+
+/**
+ * @brief A Bloom filter over node IDs.
+ *
+ * The filter answers whether a node ID <i>might</i> be held by any of the
+ * lexical storages. A negative answer is definite, which lets the Cache
+ * turn away unknown words without touching a single storage.
+ *
+ * @class BloomFilter filter.hpp "src/filter.hpp"
+ */
+class BloomFilter {
+private:
+    QVector<quint64> m_bits;
+    quint32 m_nbits;
+    quint32 m_nhsh;
+    int m_cnt;
+
+    static void hash(const NodeId&, quint64&, quint64& );
+
+public:
+    /**
+     * @brief Null constructor; the filter holds nothing and rejects nothing.
+     * @fn BloomFilter
+     */
+    BloomFilter();
+
+    /**
+     * @brief Constructor.
+     * @fn BloomFilter
+     * @param p_cap The number of IDs the filter's sized for.
+     * @param p_fpr The targeted false-positive rate at that size.
+     */
+    explicit BloomFilter(const int, const double = 0.01);
+
+    /**
+     * @brief Adds an ID to the filter.
+     * @fn insert
+     * @param p_id The ID to add.
+     */
+    void insert(const NodeId& );
+
+    /**
+     * @brief Determines if an ID might be held in the filter.
+     * @fn mightContain
+     * @param p_id The ID in question.
+     * @return false if the ID was definitely never inserted.
+     */
+    const bool mightContain(const NodeId& ) const;
+
+    /**
+     * @brief Determines if this filter's been sized (and thus can reject IDs).
+     * @fn isNull
+     */
+    const bool isNull() const;
+
+    /**
+     * @brief Obtains the number of IDs inserted.
+     * @fn count
+     * @note Only inserts that set a new bit are counted, so an ID inserted again isn't counted twice.
+     */
+    const int count() const;
+
+    /**
+     * @brief Obtains the number of bits used by the filter.
+     * @fn bits
+     */
+    const int bits() const;
+
+    /**
+     * @brief Obtains the number of hash functions used by the filter.
+     * @fn hashes
+     */
+    const int hashes() const;
+
+    /**
+     * @brief Estimates the current false-positive rate from the filter's fill.
+     * @fn falsePositiveRate
+     */
+    const double falsePositiveRate() const;
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
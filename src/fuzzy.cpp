@@ -0,0 +1,221 @@
+/**
+ * @file fuzzy.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <QSet>
+#include <QtAlgorithms>
+#include "config.hpp"
+#include "fuzzy.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+
+/// @note Only this many leading characters are filed; the rest are left to the final measure.
+static const int FUZZY_PREFIX = 7;
+
+static void gatherDeletions(const QString& p_wrd, const int p_dist, QSet<QString>& p_dels) {
+    if (p_dist <= 0)
+        return;
+
+    for (int i = 0; i < p_wrd.length(); i++) {
+        QString l_del = p_wrd;
+        l_del.remove(i, 1);
+
+        // A deletion's always as far from the word as it's shorter, so the first visit is as good as any.
+        if (!p_dels.contains(l_del)) {
+            p_dels.insert(l_del);
+            gatherDeletions(l_del, p_dist - 1, p_dels);
+        }
+    }
+}
+
+static const QSet<QString> deletionsOf(const QString& p_wrd, const int p_dist) {
+    const QString l_pfx = p_wrd.left(FUZZY_PREFIX);
+    QSet<QString> l_dels;
+    l_dels.insert(l_pfx);
+    gatherDeletions(l_pfx, p_dist, l_dels);
+    return l_dels;
+}
+
+static bool isNearer(const FuzzyIndex::Match& p_a, const FuzzyIndex::Match& p_b) {
+    if (p_a.m_dist != p_b.m_dist)
+        return p_a.m_dist < p_b.m_dist;
+
+    return p_a.m_sym < p_b.m_sym;
+}
+
+FuzzyIndex::FuzzyIndex() : m_syms(), m_ids(), m_dels(), m_frsh(), m_dist(qMax(WNTRDATA_FUZZY_DISTANCE, 0)), m_cnt(0) { }
+
+/// @note The table's entries are the hash of a deletion in the upper half and the symbol's slot in the lower.
+void FuzzyIndex::candidates(const uint p_hsh, QList<int>& p_slts) const {
+    const quint64 l_key = ((quint64) p_hsh) << 32;
+    QVector<quint64>::ConstIterator l_itr = qLowerBound(m_dels.constBegin(), m_dels.constEnd(), l_key);
+    for (; l_itr != m_dels.constEnd() && ((*l_itr) >> 32) == p_hsh; ++l_itr)
+        p_slts << (int) ((*l_itr) & Q_UINT64_C(0xffffffff));
+
+    QMultiHash<uint, int>::ConstIterator l_frsh = m_frsh.constFind(p_hsh);
+    for (; l_frsh != m_frsh.constEnd() && l_frsh.key() == p_hsh; ++l_frsh)
+        p_slts << l_frsh.value();
+}
+
+const int FuzzyIndex::slotOf(const QString& p_key) const {
+    QList<int> l_slts;
+    candidates(qHash(p_key.left(FUZZY_PREFIX)), l_slts);
+    foreach (const int l_slt, l_slts) {
+        if (m_syms.at(l_slt) == p_key)
+            return l_slt;
+    }
+
+    return -1;
+}
+
+void FuzzyIndex::insert(const QString& p_sym, const NodeId& p_id) {
+    const QString l_key = p_sym.toLower();
+    const int l_slt = slotOf(l_key);
+    if (l_slt != -1) {
+        m_ids[l_slt] = p_id;
+        return;
+    }
+
+    m_syms << l_key;
+    m_ids << p_id;
+    m_cnt++;
+
+    foreach (const QString& l_del, deletionsOf(l_key, m_dist))
+        m_frsh.insert(qHash(l_del), m_syms.count() - 1);
+}
+
+/// @note The slot's deletions stay filed; they're skipped until the next build drops them.
+const bool FuzzyIndex::remove(const QString& p_sym) {
+    const int l_slt = slotOf(p_sym.toLower());
+    if (l_slt == -1)
+        return false;
+
+    m_syms[l_slt] = QString();
+    m_ids[l_slt] = NodeId();
+    m_cnt--;
+    return true;
+}
+
+void FuzzyIndex::freeze() {
+    if (m_frsh.isEmpty())
+        return;
+
+    m_dels.reserve(m_dels.count() + m_frsh.count());
+    for (QMultiHash<uint, int>::ConstIterator l_itr = m_frsh.constBegin(); l_itr != m_frsh.constEnd(); ++l_itr)
+        m_dels << ((((quint64) l_itr.key()) << 32) | (quint32) l_itr.value());
+
+    m_frsh.clear();
+    qSort(m_dels);
+    m_dels.squeeze();
+}
+
+const FuzzyIndex::MatchList FuzzyIndex::search(const QString& p_wrd, const int p_dist, const int p_lmt) const {
+    MatchList l_mtchs;
+    if (p_lmt <= 0 || p_wrd.isEmpty())
+        return l_mtchs;
+
+    const QString l_wrd = p_wrd.toLower();
+    const int l_dist = qBound(0, p_dist, m_dist);
+    QSet<int> l_seen;
+
+    foreach (const QString& l_del, deletionsOf(l_wrd, l_dist)) {
+        QList<int> l_slts;
+        candidates(qHash(l_del), l_slts);
+
+        foreach (const int l_slt, l_slts) {
+            if (l_seen.contains(l_slt))
+                continue;
+
+            l_seen.insert(l_slt);
+            const QString& l_sym = m_syms.at(l_slt);
+            if (l_sym.isEmpty() || qAbs(l_sym.length() - l_wrd.length()) > l_dist)
+                continue;
+
+            const int l_msr = measure(l_wrd, l_sym, l_dist);
+            if (l_msr > l_dist)
+                continue;
+
+            Match l_mtch;
+            l_mtch.m_sym = l_sym;
+            l_mtch.m_id = m_ids.at(l_slt);
+            l_mtch.m_dist = l_msr;
+            l_mtchs << l_mtch;
+        }
+    }
+
+    qSort(l_mtchs.begin(), l_mtchs.end(), isNearer);
+    return l_mtchs.mid(0, p_lmt);
+}
+
+/// @note Each row's least value never drops in the next one, so the walk stops once a row's past p_max.
+const int FuzzyIndex::measure(const QString& p_a, const QString& p_b, const int p_max) {
+    const int l_la = p_a.length(), l_lb = p_b.length();
+    if (qAbs(l_la - l_lb) > p_max)
+        return p_max + 1;
+
+    QVector<int> l_prv2(l_lb + 1), l_prv(l_lb + 1), l_cur(l_lb + 1);
+    for (int j = 0; j <= l_lb; j++)
+        l_prv[j] = j;
+
+    for (int i = 1; i <= l_la; i++) {
+        l_cur[0] = i;
+        int l_min = i;
+
+        for (int j = 1; j <= l_lb; j++) {
+            const int l_cst = (p_a.at(i - 1) == p_b.at(j - 1)) ? 0 : 1;
+            int l_val = qMin(qMin(l_prv[j] + 1, l_cur[j - 1] + 1), l_prv[j - 1] + l_cst);
+            if (i > 1 && j > 1 && p_a.at(i - 1) == p_b.at(j - 2) && p_a.at(i - 2) == p_b.at(j - 1))
+                l_val = qMin(l_val, l_prv2[j - 2] + 1);
+
+            l_cur[j] = l_val;
+            l_min = qMin(l_min, l_val);
+        }
+
+        if (l_min > p_max)
+            return p_max + 1;
+
+        qSwap(l_prv2, l_prv);
+        qSwap(l_prv, l_cur);
+    }
+
+    return qMin(l_prv[l_lb], p_max + 1);
+}
+
+const int FuzzyIndex::count() const {
+    return m_cnt;
+}
+
+const int FuzzyIndex::deletions() const {
+    return m_dels.count() + m_frsh.count();
+}
+
+const int FuzzyIndex::distance() const {
+    return m_dist;
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,155 @@
+/**
+ * @file fuzzy.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef FUZZY_HPP
+#define FUZZY_HPP
+
+#include <QList>
+#include <QMultiHash>
+#include <QString>
+#include <QVector>
+#include "node.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct FuzzyIndex;
+
+/**
+ * @brief An index for finding the symbols of a locale within an edit distance of a word.
+ *
+ * This is a deletion dictionary (after SymSpell): every symbol is filed
+ * under each string obtained by deleting up to WNTRDATA_FUZZY_DISTANCE
+ * characters from its first few characters. A misspelled word yields its
+ * own deletions, and any symbol sharing one of them is a candidate; the
+ * candidates are then measured with the optimal string alignment
+ * distance (i.e.: Levenshtein, counting swapped neighbours as one edit).
+ * Finding the candidates is a handful of hash lookups, no matter how many
+ * symbols are held.
+ *
+ * The deletions filed when the index is built are packed into one sorted
+ * table by freeze(); those filed by later inserts are kept in a hash until
+ * the next build.
+ *
+ * @class FuzzyIndex fuzzy.hpp "src/fuzzy.hpp"
+ */
+class FuzzyIndex {
+public:
+    /**
+     * @brief A symbol found near a word.
+     */
+    struct Match {
+        QString m_sym;  /**< The symbol, in lower case. */
+        NodeId m_id;    /**< The ID of its node. */
+        int m_dist;     /**< Its distance from the word. */
+    };
+
+    typedef QList<Match> MatchList;
+
+private:
+    QVector<QString> m_syms;
+    QVector<NodeId> m_ids;
+    QVector<quint64> m_dels;
+    QMultiHash<uint, int> m_frsh;
+    int m_dist;
+    int m_cnt;
+
+    const int slotOf(const QString& ) const;
+    void candidates(const uint, QList<int>& ) const;
+
+public:
+    /**
+     * @brief Null constructor; an empty index.
+     * @fn FuzzyIndex
+     */
+    FuzzyIndex();
+
+    /**
+     * @brief Maps a symbol to the ID of its node, replacing any earlier mapping.
+     * @fn insert
+     * @param p_sym The symbol in question.
+     * @param p_id The ID of its node.
+     */
+    void insert(const QString&, const NodeId& );
+
+    /**
+     * @brief Drops the mapping of a symbol.
+     * @fn remove
+     * @param p_sym The symbol in question.
+     * @return false if the symbol wasn't mapped.
+     */
+    const bool remove(const QString& );
+
+    /**
+     * @brief Packs the deletions filed since the last call into the sorted table.
+     * @fn freeze
+     * @note This is meant to be called once the index has been built.
+     */
+    void freeze();
+
+    /**
+     * @brief Finds the symbols within an edit distance of a word.
+     * @fn search
+     * @param p_wrd The word in question; it's compared in lower case.
+     * @param p_dist The greatest distance to accept; it's capped at distance().
+     * @param p_lmt The most symbols to find.
+     * @return The symbols found, nearest first; those at the same distance are sorted.
+     */
+    const MatchList search(const QString&, const int, const int ) const;
+
+    /**
+     * @brief Obtains the number of symbols mapped.
+     * @fn count
+     */
+    const int count() const;
+
+    /**
+     * @brief Obtains the number of deletions filed.
+     * @fn deletions
+     */
+    const int deletions() const;
+
+    /**
+     * @brief Obtains the greatest distance the index can search within.
+     * @fn distance
+     */
+    const int distance() const;
+
+    /**
+     * @brief Measures the optimal string alignment distance between two strings.
+     * @fn measure
+     * @param p_a The first string.
+     * @param p_b The second string.
+     * @param p_max The greatest distance of interest.
+     * @return The distance, or p_max + 1 if it's greater than p_max.
+     */
+    static const int measure(const QString&, const QString&, const int );
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,99 @@
+/**
+ * @file index.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include "index.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+
+LocaleIndex::LocaleIndex() : m_syms(), m_fzzy(), m_lnks() { }
+
+/// @note Several flags of a node may carry the same code; it's only filed once.
+const QVector<Atom> LocaleIndex::linksOf(const Node& p_nd) {
+    QVector<Atom> l_codes;
+    const FlagList& l_flgs = p_nd.flagList();
+    for (int i = 0; i < l_flgs.count(); i++) {
+        const Atom l_code = l_flgs.at(i).m_link;
+        if (l_code != 0 && !l_codes.contains(l_code))
+            l_codes << l_code;
+    }
+
+    return l_codes;
+}
+
+void LocaleIndex::add(const Node& p_nd) {
+    foreach (const Atom l_code, linksOf(p_nd))
+        m_lnks.insert(l_code, p_nd.nodeId());
+
+    if (p_nd.symbol().isEmpty())
+        return;
+
+    m_syms.insert(p_nd.symbol(), p_nd.nodeId());
+    m_fzzy.insert(p_nd.symbol(), p_nd.nodeId());
+}
+
+void LocaleIndex::remove(const Node& p_nd) {
+    foreach (const Atom l_code, linksOf(p_nd))
+        m_lnks.remove(l_code, p_nd.nodeId());
+
+    if (p_nd.symbol().isEmpty())
+        return;
+
+    m_syms.remove(p_nd.symbol());
+    m_fzzy.remove(p_nd.symbol());
+}
+
+const SymbolTrie& LocaleIndex::symbols() const {
+    return m_syms;
+}
+
+const FuzzyIndex& LocaleIndex::fuzzy() const {
+    return m_fzzy;
+}
+
+const LinkIndex& LocaleIndex::links() const {
+    return m_lnks;
+}
+
+void LocaleIndex::freeze() {
+    m_fzzy.freeze();
+    m_lnks.freeze();
+}
+
+const QVariantMap LocaleIndex::toMap() const {
+    QVariantMap l_map;
+    l_map["Symbols"] = m_syms.count();
+    l_map["TrieVertices"] = m_syms.vertices();
+    l_map["FuzzyDeletions"] = m_fzzy.deletions();
+    l_map["FuzzyDistance"] = m_fzzy.distance();
+    l_map["LinkCodes"] = m_lnks.codes().count();
+    l_map["LinkEntries"] = m_lnks.entries();
+    return l_map;
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
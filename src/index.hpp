@@ -0,0 +1,114 @@
+/**
+ * @file index.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef INDEX_HPP
+#define INDEX_HPP
+
+#include <QVariantMap>
+#include "trie.hpp"
+#include "fuzzy.hpp"
+#include "links.hpp"
+#include "node.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct LocaleIndex;
+
+/**
+ * @brief The in-memory indexes over the nodes of a locale.
+ *
+ * Like a Tally, a LocaleIndex is built in one pass over a locale's nodes
+ * when the lexicon's generated and is then kept up to date with every
+ * write, so answering from it never touches the storages. It isn't saved;
+ * it's rebuilt whenever the lexicon's generated.
+ *
+ * @class LocaleIndex index.hpp "src/index.hpp"
+ */
+class LocaleIndex {
+private:
+    SymbolTrie m_syms;
+    FuzzyIndex m_fzzy;
+    LinkIndex m_lnks;
+
+    static const QVector<Atom> linksOf(const Node& );
+
+public:
+    /**
+     * @brief Null constructor; an empty index.
+     * @fn LocaleIndex
+     */
+    LocaleIndex();
+
+    /**
+     * @brief Indexes a node.
+     * @fn add
+     * @param p_nd The node in question.
+     */
+    void add(const Node& );
+
+    /**
+     * @brief Drops a node from the index.
+     * @fn remove
+     * @param p_nd The node in question, as it was indexed.
+     */
+    void remove(const Node& );
+
+    /**
+     * @brief Obtains the trie of the locale's symbols.
+     * @fn symbols
+     */
+    const SymbolTrie& symbols() const;
+
+    /**
+     * @brief Obtains the deletion dictionary of the locale's symbols.
+     * @fn fuzzy
+     */
+    const FuzzyIndex& fuzzy() const;
+
+    /**
+     * @brief Obtains the inverted index of the link codes of the locale's flags.
+     * @fn links
+     */
+    const LinkIndex& links() const;
+
+    /**
+     * @brief Packs what's been indexed so far; called once the index has been built.
+     * @fn freeze
+     */
+    void freeze();
+
+    /**
+     * @brief Represents the sizes of the index as a map (i.e.: for D-Bus).
+     * @fn toMap
+     */
+    const QVariantMap toMap() const;
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -27,6 +27,8 @@
 #include <QtCore/QString>
 #include <QtCore/QVariant>
 #include <QtDBus/QtDBus>
+#include <qjson/serializer.h>
+#include <qjson/qobjecthelper.h>
 #include "models.hpp"
 #include "config.hpp"
 
@@ -91,6 +93,70 @@ public slots:
         return asyncCallWithArgumentList(QLatin1String("write"), argumentList);
     }
 
+    inline QDBusPendingReply<int> writeBatch(QList<Lexical::Data> in0, int in1) {
+        QVariantList l_nodes;
+        foreach (const Lexical::Data& l_dt, in0)
+            l_nodes << QJson::QObjectHelper::qobject2qvariant(&l_dt);
+
+        QJson::Serializer l_serializer;
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(QString(l_serializer.serialize(l_nodes))) << qVariantFromValue(in1);
+        return asyncCallWithArgumentList(QLatin1String("writeBatch"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> statistics() {
+        QList<QVariant> argumentList;
+        return asyncCallWithArgumentList(QLatin1String("statistics"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> scanNodes(QString in0, QString in1, int in2) {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(in0) << qVariantFromValue(in1) << qVariantFromValue(in2);
+        return asyncCallWithArgumentList(QLatin1String("scanNodes"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> prefixSearch(QString in0, QString in1, int in2) {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(in0) << qVariantFromValue(in1) << qVariantFromValue(in2);
+        return asyncCallWithArgumentList(QLatin1String("prefixSearch"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> readApproximate(QString in0, int in1) {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(in0) << qVariantFromValue(in1);
+        return asyncCallWithArgumentList(QLatin1String("readApproximate"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> fuzzySearch(QString in0, QString in1, int in2, int in3) {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(in0) << qVariantFromValue(in1) << qVariantFromValue(in2) << qVariantFromValue(in3);
+        return asyncCallWithArgumentList(QLatin1String("fuzzySearch"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> linkSearch(QString in0, QString in1, bool in2, int in3) {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(in0) << qVariantFromValue(in1) << qVariantFromValue(in2) << qVariantFromValue(in3);
+        return asyncCallWithArgumentList(QLatin1String("linkSearch"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> linkCodes(QString in0, QString in1) {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(in0) << qVariantFromValue(in1);
+        return asyncCallWithArgumentList(QLatin1String("linkCodes"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> unloadIdle(int in0) {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(in0);
+        return asyncCallWithArgumentList(QLatin1String("unloadIdle"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> rangeSearch(QString in0, QString in1, QString in2, int in3) {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(in0) << qVariantFromValue(in1) << qVariantFromValue(in2) << qVariantFromValue(in3);
+        return asyncCallWithArgumentList(QLatin1String("rangeSearch"), argumentList);
+    }
+
 Q_SIGNALS: // SIGNALS
     void nodeCreated(const QString &in0);
 };
@@ -0,0 +1,204 @@
+/**
+ * @file journal.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <QtEndian>
+#include <QDataStream>
+#include <QMutexLocker>
+#include "journal.hpp"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+static const quint32 JOURNAL_HEADER = 8;
+static const quint16 JOURNAL_NODEID = 2;
+static const quint32 JOURNAL_IDSIZE = 16;
+static const quint32 JOURNAL_MAXRECORD = 16 * 1024 * 1024;
+
+Journal::Journal(const QString& p_pth) : m_file(p_pth), m_mtx() { }
+
+Journal::~Journal() {
+    close();
+}
+
+const QString Journal::path() const {
+    return m_file.fileName();
+}
+
+const bool Journal::open() {
+    QMutexLocker l_lck(&m_mtx);
+    if (m_file.isOpen())
+        return true;
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "(data) [Journal] Can't open" << m_file.fileName() << ":" << m_file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void Journal::close() {
+    QMutexLocker l_lck(&m_mtx);
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+const qint64 Journal::size() const {
+    QMutexLocker l_lck(&m_mtx);
+    return m_file.size();
+}
+
+/// @note Frames one record into the buffer; header and payload go out in the same write, so a crash tears at most the tail.
+static void encode(const Node& p_nd, QByteArray& p_buf) {
+    uchar l_id[JOURNAL_IDSIZE];
+    p_nd.nodeId().toBytes(l_id);
+
+    QByteArray l_body;
+    QDataStream l_strm(&l_body, QIODevice::WriteOnly);
+    l_strm.setVersion(QDataStream::Qt_4_6);
+    l_strm << p_nd.symbol() << p_nd.flags();
+
+    const QByteArray l_pld = QByteArray((const char*) l_id, JOURNAL_IDSIZE) + l_body;
+
+    uchar l_hdr[JOURNAL_HEADER];
+    qToLittleEndian<quint32>((quint32) l_pld.size(), l_hdr);
+    qToLittleEndian<quint16>(qChecksum(l_pld.constData(), l_pld.size()), l_hdr + 4);
+    qToLittleEndian<quint16>(JOURNAL_NODEID, l_hdr + 6);
+
+    p_buf.append((const char*) l_hdr, JOURNAL_HEADER);
+    p_buf.append(l_pld);
+}
+
+const bool Journal::append(const Node& p_nd) {
+    QList<Node> l_nodes;
+    l_nodes << p_nd;
+    return append(l_nodes, Storage::DurabilityFlush);
+}
+
+const bool Journal::append(const QList<Node>& p_nodes, const Storage::Durability p_drblty) {
+    QByteArray l_buf;
+    foreach (const Node& l_nd, p_nodes)
+        encode(l_nd, l_buf);
+
+    QMutexLocker l_lck(&m_mtx);
+    if (!m_file.isOpen()) {
+        qWarning() << "(data) [Journal] Appending to closed journal" << m_file.fileName() << ".";
+        return false;
+    }
+
+    if (m_file.write(l_buf) != l_buf.size()) {
+        qWarning() << "(data) [Journal] Failed appending to" << m_file.fileName() << ":" << m_file.errorString();
+        return false;
+    }
+
+    if (p_drblty == Storage::DurabilityNone)
+        return true;
+
+    if (!m_file.flush()) {
+        qWarning() << "(data) [Journal] Failed flushing" << m_file.fileName() << ":" << m_file.errorString();
+        return false;
+    }
+
+    if (p_drblty == Storage::DurabilitySync && !sync()) {
+        qWarning() << "(data) [Journal] Failed syncing" << m_file.fileName() << ".";
+        return false;
+    }
+
+    return true;
+}
+
+/// @note Expects m_mtx to be held and the file to be flushed.
+const bool Journal::sync() {
+#ifdef Q_OS_WIN
+    return _commit(m_file.handle()) == 0;
+#else
+    return ::fsync(m_file.handle()) == 0;
+#endif
+}
+
+const int Journal::replay(const QString& p_pth, const QString& p_lcl, QHash<NodeId, Node>& p_nodes) {
+    QFile l_file(p_pth);
+    if (!l_file.exists())
+        return 0;
+
+    if (!l_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "(data) [Journal] Can't replay" << p_pth << ":" << l_file.errorString();
+        return 0;
+    }
+
+    const QByteArray l_bytes = l_file.readAll();
+    const uchar* l_raw = (const uchar*) l_bytes.constData();
+    const quint32 l_sz = (quint32) l_bytes.size();
+    const Atom l_lcl = Atoms::intern(p_lcl);
+    quint32 l_pos = 0;
+    int l_cnt = 0;
+
+    while (l_pos + JOURNAL_HEADER <= l_sz) {
+        const quint32 l_len = qFromLittleEndian<quint32>(l_raw + l_pos);
+        const quint16 l_sum = qFromLittleEndian<quint16>(l_raw + l_pos + 4);
+        const quint16 l_knd = qFromLittleEndian<quint16>(l_raw + l_pos + 6);
+
+        if (l_knd != JOURNAL_NODEID || l_len > JOURNAL_MAXRECORD || l_len > l_sz - l_pos - JOURNAL_HEADER ||
+                l_len < JOURNAL_IDSIZE)
+            break;
+
+        const char* l_pld = l_bytes.constData() + l_pos + JOURNAL_HEADER;
+        if (qChecksum(l_pld, l_len) != l_sum)
+            break;
+
+        const NodeId l_id = NodeId::fromBytes((const uchar*) l_pld);
+        QString l_sym;
+        QVariantMap l_flgs;
+        QDataStream l_strm(QByteArray::fromRawData(l_pld + JOURNAL_IDSIZE, l_len - JOURNAL_IDSIZE));
+        l_strm.setVersion(QDataStream::Qt_4_6);
+        l_strm >> l_sym >> l_flgs;
+
+        if (l_strm.status() != QDataStream::Ok)
+            break;
+
+        p_nodes.insert(l_id, Node(l_id, l_lcl, l_sym, FlagSets::intern(Node::toFlagList(l_flgs))));
+        l_pos += JOURNAL_HEADER + l_len;
+        l_cnt++;
+    }
+
+    if (l_pos < l_sz) {
+        qWarning() << "(data) [Journal] Dropping" << (l_sz - l_pos) << "torn bytes from the tail of" << p_pth << ".";
+        l_file.resize(l_pos);
+    }
+
+    l_file.close();
+    qDebug() << "(data) [Journal] Replayed" << l_cnt << "records from" << p_pth;
+    return l_cnt;
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
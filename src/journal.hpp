@@ -0,0 +1,129 @@
+/**
+ * @file journal.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <QHash>
+#include <QFile>
+#include <QMutex>
+#include "lexical.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct Journal;
+
+/**
+ * @brief An append-only write-ahead log of the nodes written to a locale.
+ *
+ * Each record is framed as a little-endian quint32 payload length, a
+ * quint16 checksum of the payload and a quint16 record kind, followed by
+ * the payload: the node's 16-byte ID, then its symbol and flags in
+ * QDataStream format.
+ * A record that's torn or fails its checksum marks the end of the log;
+ * replay() cuts it off so the next append starts on a clean boundary.
+ *
+ * @class Journal journal.hpp "src/journal.hpp"
+ */
+class Journal {
+    Q_DISABLE_COPY(Journal)
+
+private:
+    QFile m_file;
+    mutable QMutex m_mtx;
+
+    const bool sync();
+
+public:
+    /**
+     * @brief Constructor.
+     * @fn Journal
+     * @param p_pth The path to the journal.
+     */
+    explicit Journal(const QString& );
+
+    /**
+     * @brief Deconstructor; closes the journal.
+     * @fn ~Journal
+     */
+    ~Journal();
+
+    /**
+     * @brief Obtains the path of this journal.
+     * @fn path
+     */
+    const QString path() const;
+
+    /**
+     * @brief Opens the journal for appending, creating it if needed.
+     * @fn open
+     */
+    const bool open();
+
+    /**
+     * @brief Closes the journal.
+     * @fn close
+     */
+    void close();
+
+    /**
+     * @brief Obtains the size of the journal, in bytes.
+     * @fn size
+     */
+    const qint64 size() const;
+
+    /**
+     * @brief Appends a node to the journal and flushes it to the system.
+     * @fn append
+     * @param p_nd The node to be journaled.
+     */
+    const bool append(const Node& );
+
+    /**
+     * @brief Appends a batch of nodes to the journal in a single write.
+     * @fn append
+     * @param p_nodes The nodes to be journaled.
+     * @param p_drblty How hard the batch is pushed to disk.
+     */
+    const bool append(const QList<Node>&, const Storage::Durability );
+
+    /**
+     * @brief Reads every intact record of the journal at the specified path.
+     * @fn replay
+     * @param p_pth The path to the journal.
+     * @param p_lcl The locale the journal belongs to.
+     * @param p_nodes The nodes read, keyed by ID; later records win.
+     * @return The number of records read.
+     * @note A torn tail left behind by a crash is truncated away.
+     */
+    static const int replay(const QString&, const QString&, QHash<NodeId, Node>& );
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -21,83 +21,145 @@
  * @endlegalese
 */
 
+#include <algorithm>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QThread>
+#include <QRunnable>
+#include <QWaitCondition>
+#include <QSet>
+#include <QTime>
+#include <QSharedPointer>
+#include <QXmlStreamWriter>
 #include <QString>
+#include <QtAlgorithms>
 #include <qjson/parser.h>
 #include <qjson/serializer.h>
 #include <qjson/qobjecthelper.h>
 
 #include "md5.hpp"
+#include "config.hpp"
 #include "lexical.hpp"
+#include "snapshot.hpp"
+#include "nodexml.hpp"
 
 namespace Wintermute {
 namespace Data {
 namespace Linguistics {
 namespace Lexical {
-Cache::StorageList Cache::s_stores;
+Cache::GenerationPointer Cache::s_gen(new Cache::Generation);
+QReadWriteLock Cache::s_genLck;
+QReadWriteLock Cache::s_rldLck;
+QMutex Cache::s_rldMtx;
+QReadWriteLock Cache::s_lclsLck;
+QMutex Cache::s_ldMtx;
+QCache<Cache::NodeKey, Node> Cache::s_nodes(WNTRDATA_NODE_CACHE_SIZE);
+QHash<QString, Node> Cache::s_psds;
+QMutex Cache::s_nodesMtx;
+int Cache::s_wrtEpch = 0;
+QReadWriteLock Cache::s_fltrsLck;
+QAtomicInt Cache::s_fltrQrs;
+QAtomicInt Cache::s_fltrRjcts;
+QAtomicInt Cache::s_fltrFps;
+QThreadPool Cache::s_prbPool;
+QHash<QString, int> Cache::s_prbTmouts;
+Cache::ProbeMode Cache::s_prbMode = Cache::ProbePriority;
+QMutex Cache::s_prbMtx;
+QAtomicInt Cache::s_prbTmdOut;
+QHash<QString, Tally> Cache::s_tlls;
+QMutex Cache::s_tllsMtx;
+QMutex Cache::s_wrtMtx;
+QHash<QString, LocaleIndex> Cache::s_idxs;
+QReadWriteLock Cache::s_idxsLck;
+QHash<QString, DomStorage::Template> DomStorage::s_tmpls;
+QMutex DomStorage::s_tmplMtx;
+
+/// @note node.xml is hashed and streamed in blocks of this many bytes, so it's never held whole.
+static const int DOMSTORAGE_READ_BLOCK = 65536;
+
+/// @note Nodes are spawned in chunks so that a large locale keeps every spawning thread busy.
+static const int DOMSTORAGE_SPAWN_CHUNK = 256;
+
+/// @note Tallies are saved every so many writes; a crash in between leaves the tally marked dirty, so it's recounted when next used.
+static const int CACHE_TALLY_INTERVAL = 64;
 const Data Data::Null = Data();
 
-Data::Data() : m_id(), m_lcl(), m_sym(), m_flg() { }
+Data::Data() : QObject(), m_nd() { }
 
-Data::Data(const Data &p_dt) : m_id(p_dt.m_id),
-        m_lcl(p_dt.m_lcl), m_sym(p_dt.m_sym), m_flg(p_dt.m_flg) { }
+Data::Data(const Data &p_dt) : QObject(), m_nd(p_dt.m_nd) { }
 
-Data::Data(QString p_id, QString p_lcl, QString p_sym, QVariantMap p_flg) : m_id(p_id),
-        m_lcl(p_lcl), m_sym(p_sym), m_flg(p_flg) { }
+Data::Data(const Node &p_nd) : QObject(), m_nd(p_nd) { }
+
+Data::Data(QString p_id, QString p_lcl, QString p_sym, QVariantMap p_flg) : QObject(),
+        m_nd(p_id,p_lcl,p_sym,p_flg) { }
 
 const QVariantMap Data::flags () const {
-    return m_flg;
+    return m_nd.flags ();
 }
 
 const QString Data::symbol () const {
-    return m_sym;
+    return m_nd.symbol ();
 }
 
 const QString Data::id () const {
-    return m_id;
+    return m_nd.id ();
+}
+
+const NodeId Data::nodeId () const {
+    return m_nd.nodeId ();
 }
 
 const QString Data::locale () const {
-    return m_lcl;
+    return m_nd.locale ();
+}
+
+const Node& Data::node () const {
+    return m_nd;
+}
+
+void Data::setNode (const Node& p_nd) {
+    m_nd = p_nd;
 }
 
 void Data::setSymbol(const QString& l_sym) {
-    m_sym = l_sym;
-    m_id = Data::idFromString (m_sym);
+    m_nd.setSymbol (l_sym);
 }
 
 void Data::setLocale(const QString& l_lcl) {
-    m_lcl = l_lcl;
+    m_nd.setLocale (l_lcl);
 }
 
 void Data::setID (const QString &l_id) {
-    m_id = l_id;
+    m_nd.setID (l_id);
 }
 
 void Data::setFlags(const QVariantMap& l_flg) {
-    m_flg = l_flg;
+    m_nd.setFlags (l_flg);
 }
 
 bool Data::operator== (const Data& p_otherDt) const {
-    return ((m_flg == p_otherDt.m_flg) && (m_sym == p_otherDt.m_sym) &&
-            (m_lcl == p_otherDt.m_lcl) && (m_id == p_otherDt.m_id));
+    return m_nd == p_otherDt.m_nd;
 }
 
 void Data::operator= (const Data& p_otherDt) {
-    m_flg = p_otherDt.m_flg;
-    m_sym = p_otherDt.m_sym;
-    m_lcl = p_otherDt.m_lcl;
-    m_id = p_otherDt.m_id;
+    m_nd = p_otherDt.m_nd;
 }
 
 const bool Data::isNull () const {
-    return Data::Null == *this;
+    return m_nd.isNull ();
 }
 
-/// @todo Use MD-5 hashing from another library (QCA has it) so we can eliminate md5.*pp.
 const QString Data::idFromString (const QString p_sym) {
-    return QString::fromStdString (md5(p_sym.toLower ().toStdString ()));
+    return Node::idFromString (p_sym);
+}
+
+const QStringList Data::idsFromStrings (const QStringList& p_syms) {
+    return Node::idsFromStrings (p_syms);
 }
 
 QString Data::toString() const {
@@ -121,14 +183,17 @@ Data::operator QVariant() const {
 Data::~Data () { }
 
 QDebug operator<<(QDebug dbg, const Data& p_nd) {
-    dbg << "(Lexical::Data) ID:" << p_nd.m_id << ", Locale:" << p_nd.m_lcl
-    << ", Symbol:"<< p_nd.m_sym << ", Flags:" << p_nd.m_flg;
+    dbg << "(Lexical::Data) ID:" << p_nd.id () << ", Locale:" << p_nd.locale ()
+    << ", Symbol:"<< p_nd.symbol () << ", Flags:" << p_nd.flags ();
     return dbg.nospace();
 }
 
 const QDBusArgument& operator>> (const QDBusArgument &p_arg, Data& p_dt) {
+    QString l_lcl, l_id, l_sym;
+    FlagList l_flgs;
+
     p_arg.beginStructure();
-    p_arg >> p_dt.m_lcl >> p_dt.m_id >> p_dt.m_sym;
+    p_arg >> l_lcl >> l_id >> l_sym;
 
     p_arg.beginMap();
 
@@ -138,26 +203,27 @@ const QDBusArgument& operator>> (const QDBusArgument &p_arg, Data& p_dt) {
         p_arg.beginMapEntry();
         p_arg >> l_key >> l_value;
         p_arg.endMapEntry();
-        p_dt.m_flg.insert(l_key,l_value);
+        l_flgs.append(Flag(l_key,l_value.toString ()));
     }
 
     p_arg.endMap();
 
     p_arg.endStructure();
+    p_dt.m_nd = Node(l_id,l_lcl,l_sym,l_flgs);
     return p_arg;
 }
 
 QDBusArgument& operator<< (QDBusArgument &p_arg, const Data& p_dt) {
     p_arg.beginStructure();
-    p_arg << p_dt.m_lcl << p_dt.m_id << p_dt.m_sym;
+    p_arg << p_dt.locale () << p_dt.id () << p_dt.symbol ();
 
     p_arg.beginMap(QVariant::String, QVariant::String);
 
-    QVariantMap::ConstIterator l_itr = p_dt.m_flg.constBegin(), l_end = p_dt.m_flg.constEnd();
-    for (; l_itr != l_end; ++l_itr) {
+    const FlagList& l_flgs = p_dt.m_nd.flagList ();
+    for (int i = 0; i < l_flgs.count (); i++) {
         p_arg.beginMapEntry();
-        p_arg << l_itr.key()
-        << l_itr.value().toString();
+        p_arg << l_flgs.at (i).guid ()
+        << l_flgs.at (i).link ();
         p_arg.endMapEntry();
     }
 
@@ -168,14 +234,15 @@ QDBusArgument& operator<< (QDBusArgument &p_arg, const Data& p_dt) {
 }
 
 QDataStream& operator<<(QDataStream& p_strm, const Data& p_dt) {
-    qDebug() << p_dt.m_id << p_dt.m_lcl << p_dt.m_sym << p_dt.m_flg;
-    p_strm << p_dt.m_id << p_dt.m_lcl << p_dt.m_sym << p_dt.m_flg;
+    p_strm << p_dt.id () << p_dt.locale () << p_dt.symbol () << p_dt.flags ();
     return p_strm;
 }
 
 QDataStream& operator>>(QDataStream& p_strm, Data& p_dt) {
-    qDebug() << p_dt.m_id << p_dt.m_lcl << p_dt.m_sym << p_dt.m_flg;
-    p_strm >> p_dt.m_id >> p_dt.m_lcl >> p_dt.m_sym >> p_dt.m_flg;
+    QString l_id, l_lcl, l_sym;
+    QVariantMap l_flg;
+    p_strm >> l_id >> l_lcl >> l_sym >> l_flg;
+    p_dt.m_nd = Node(l_id,l_lcl,l_sym,l_flg);
     return p_strm;
 }
 
@@ -215,6 +282,55 @@ SaveModel::~SaveModel() { }
 
 Storage::Storage() { }
 
+Storage::~Storage() { }
+
+const bool Storage::nodes(const QString& p_lcl, NodeIdList& p_ids) const {
+    Q_UNUSED(p_lcl);
+    Q_UNUSED(p_ids);
+    return false;
+}
+
+const bool Storage::isJournaled() const {
+    return false;
+}
+
+const bool Storage::scan(const QString& p_lcl, const NodeId& p_aftr, const int p_lmt, NodeIdList& p_ids) const {
+    Q_UNUSED(p_lcl);
+    Q_UNUSED(p_aftr);
+    Q_UNUSED(p_lmt);
+    Q_UNUSED(p_ids);
+    return false;
+}
+
+void Storage::settle() { }
+
+const bool Storage::prepare(const QString& p_lcl) {
+    Q_UNUSED(p_lcl);
+    return false;
+}
+
+void Storage::release(const QString& p_lcl) {
+    Q_UNUSED(p_lcl);
+}
+
+const bool Storage::saveBatch(const QList<Data>& p_nodes, const Durability p_drblty) {
+    Q_UNUSED(p_drblty);
+    foreach (const Data& l_dt, p_nodes)
+        saveFrom(l_dt);
+
+    return true;
+}
+
+void Storage::loadBatch(QList<Data>& p_nodes, QVector<bool>& p_fnd) const {
+    for (int i = 0; i < p_nodes.count(); i++) {
+        if (p_fnd.at(i) || !exists(p_nodes.at(i)))
+            continue;
+
+        loadTo(p_nodes[i]);
+        p_fnd[i] = true;
+    }
+}
+
 bool Storage::operator==(const Storage& p_store) const {
     return type() == p_store.type();
 }
@@ -261,109 +377,347 @@ void DomStorage::saveFrom (const Data &p_dt) {
     l_domSvMdl.saveFrom (p_dt);
     const QString l_str = l_dom.toByteArray(4);
 
-    QFile* l_file = new QFile(DomStorage::getPath(p_dt));
-    if (!l_file->exists ()) {
-        l_file->open (QIODevice::WriteOnly | QIODevice::Truncate);
-        l_file->write ("<!--Generated-->\n");
-        l_file->close ();
+    // A node file holds a single document; the newer copy replaces the older one.
+    QFile l_file(DomStorage::getPath(p_dt));
+    if (!l_file.open (QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "(data) [DomStorage] Failed to save node" << p_dt.id() << ":" << l_file.errorString();
+        return;
     }
 
-    l_file->open (QIODevice::WriteOnly | QIODevice::Append);
-    l_file->write(l_str.toUtf8());
-    l_file->close ();
+    l_file.write ("<!--Generated-->\n");
+    l_file.write (l_str.toUtf8());
+    l_file.close ();
+}
+
+/// @note Node files are named after their hexadecimal IDs; anything else in there isn't a node.
+const bool DomStorage::nodes(const QString& p_lcl, NodeIdList& p_ids) const {
+    foreach (const QString& l_nm, Cache::allNodes (p_lcl)) {
+        bool l_ok = false;
+        const NodeId l_id = NodeId::fromHex (l_nm,&l_ok);
+        if (l_ok)
+            p_ids << l_id;
+    }
 
+    return true;
 }
 
 const QString DomStorage::type () const {
     return "Dom";
 }
 
+/**
+ * @brief Parses a single locale's node.xml on a spawning thread.
+ * @class DomLocaleTask lexical.cpp "src/lexical.cpp"
+ */
+class DomLocaleTask : public QRunnable {
+private:
+    const QString m_pth;
+    QThreadPool* m_pool;
+
+public:
+    DomLocaleTask(const QString& p_pth, QThreadPool* p_pool) : QRunnable(), m_pth(p_pth), m_pool(p_pool) { }
+
+    virtual void run() {
+        DomStorage::spawnLocale(m_pth,m_pool);
+    }
+};
+
+/**
+ * @brief Tracks the chunks of a locale still being spawned; the last one to
+ *        finish saves the locale's manifest.
+ * @class DomSpawnJob lexical.cpp "src/lexical.cpp"
+ */
+class DomSpawnJob {
+public:
+    const QString m_pth;
+    DomStorage::Manifest m_mfst;
+    QAtomicInt m_left;
+
+    explicit DomSpawnJob(const QString& p_pth) : m_pth(p_pth), m_mfst(), m_left(0) { }
+
+    void finish() {
+        if (!m_left.deref ())
+            DomStorage::saveManifest(m_pth,m_mfst);
+    }
+};
+
+/**
+ * @brief Writes a chunk of a locale's nodes on a spawning thread.
+ * @class DomSpawnTask lexical.cpp "src/lexical.cpp"
+ */
+class DomSpawnTask : public QRunnable {
+private:
+    const QString m_dir;
+    const QList<Node> m_nodes;
+    QSharedPointer<DomSpawnJob> m_job;
+
+public:
+    DomSpawnTask(const QString& p_dir, const QList<Node>& p_nodes, const QSharedPointer<DomSpawnJob>& p_job) : QRunnable(),
+        m_dir(p_dir), m_nodes(p_nodes), m_job(p_job) { }
+
+    virtual void run() {
+        foreach (const Node& l_nd, m_nodes)
+        DomStorage::spawnNode(m_dir,Data(l_nd));
+
+        m_job->finish ();
+    }
+};
+
+/// @todo Allow the chunk size and the number of spawning threads to be configured.
 void DomStorage::generate() {
+    clearTemplates();
+
     QDir d(System::directory ());
     d.setFilter (QDir::Dirs | QDir::NoDotAndDotDot);
-    QStringList l_lclLst = d.entryList ();
+    const QStringList l_lclLst = d.entryList ();
+
+    QThreadPool l_pool;
+    l_pool.setMaxThreadCount (qMax(QThread::idealThreadCount (), 1));
+
+    foreach(const QString l_lcl, l_lclLst)
+    l_pool.start (new DomLocaleTask(d.absolutePath () + "/" + l_lcl + "/node.xml", &l_pool));
+
+    // Locale tasks queue their node chunks on the same pool; this waits for those too.
+    l_pool.waitForDone ();
+    qDebug() << "(data) [DomStorage] Spawned" << l_lclLst.count () << "locale(s) on" << l_pool.maxThreadCount () << "thread(s).";
+}
+
+const bool DomStorage::prepare(const QString& p_lcl) {
+    QThreadPool l_pool;
+    l_pool.setMaxThreadCount (qMax(QThread::idealThreadCount (), 1));
+
+    const bool l_spwnd = spawnLocale(System::directory () + "/" + p_lcl + "/node.xml",&l_pool);
+    l_pool.waitForDone ();
+    return l_spwnd;
+}
+
+void DomStorage::release(const QString& p_lcl) {
+    QMutexLocker l_lck(&s_tmplMtx);
+    s_tmpls.remove (System::directory () + "/" + p_lcl + "/node.xml");
+}
+
+const QString DomStorage::obtainFullSuffix(const QString& p_lcl, const QString& p_sfx) const {
+    const Template l_tmpl = obtainTemplate(p_lcl);
+    return l_tmpl.m_sfx.value (p_sfx, "");
+}
+
+static const QString hashOf(const QByteArray& p_bytes) {
+    return QString::fromStdString (md5(std::string(p_bytes.constData (), p_bytes.size ())));
+}
+
+static const QString hashOf(QIODevice* p_dev) {
+    MD5 l_md5;
+    QByteArray l_blk(DOMSTORAGE_READ_BLOCK, 0);
+    qint64 l_len = 0;
+    while ((l_len = p_dev->read (l_blk.data (),l_blk.size ())) > 0)
+        l_md5.update (l_blk.constData (),(MD5::size_type) l_len);
+
+    return QString::fromStdString (l_md5.finalize ().hexdigest ());
+}
 
-    foreach(const QString l_lcl, l_lclLst) {
-        qDebug() << "(data) [DomStorage] Parsing locale" << l_lcl << "...";
-        const QString l_pth = d.absolutePath () + "/" + l_lcl + "/node.xml";
-        QDomDocument l_spawnDom("Store");
-        QFile* l_file = new QFile(l_pth);
+/// @note Flags are kept sorted by GUID, so equal nodes always hash the same.
+static const QString hashOf(const Node& p_nd) {
+    QString l_str = p_nd.symbol () + "\n";
+    const FlagList& l_flgs = p_nd.flagList ();
+    for (int i = 0; i < l_flgs.count (); i++)
+        l_str += l_flgs.at (i).guid () + "=" + l_flgs.at (i).link () + "\n";
 
-        if (!l_file->exists ()) {
-            qWarning() << "(data) [DomStorage] Can't access" << l_pth << ".";
-            l_file->deleteLater ();
+    return hashOf(l_str.toUtf8 ());
+}
+
+const DomStorage::Manifest DomStorage::loadManifest(const QString& p_pth) {
+    Manifest l_mfst;
+    QFile l_file(p_pth);
+    if (!l_file.open (QIODevice::ReadOnly | QIODevice::Text))
+        return l_mfst;
+
+    QTextStream l_strm(&l_file);
+    while (!l_strm.atEnd ()) {
+        const QString l_ln = l_strm.readLine ();
+        if (l_ln.startsWith ('#'))
             continue;
-        }
 
-        if (!l_spawnDom.setContent (l_file)) {
-            qWarning() << "(data) [DomStorage] Parse error in" << l_pth << ".";
+        const QStringList l_fields = l_ln.split (" ");
+        if (l_fields.count () != 2)
             continue;
-        }
+        else if (l_fields.at (0) == "source")
+            l_mfst.m_src = l_fields.at (1);
+        else
+            l_mfst.m_ents.insert (l_fields.at (0),l_fields.at (1));
+    }
+
+    return l_mfst;
+}
 
-        spawn(l_spawnDom);
+void DomStorage::saveManifest(const QString& p_pth, const Manifest& p_mfst) {
+    QFile l_file(p_pth);
+    if (!l_file.open (QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "(data) [DomStorage] Can't write manifest" << p_pth << ":" << l_file.errorString ();
+        return;
     }
+
+    QTextStream l_strm(&l_file);
+    l_strm << "# Generated" << endl << "source " << p_mfst.m_src << endl;
+    QHash<QString, QString>::ConstIterator l_itr = p_mfst.m_ents.constBegin (), l_end = p_mfst.m_ents.constEnd ();
+    for (; l_itr != l_end; ++l_itr)
+        l_strm << l_itr.key () << " " << l_itr.value () << endl;
 }
 
-const QString DomStorage::obtainFullSuffix(const QString& p_lcl, const QString& p_sfx) const {
-    const Data l_dt(QString::null,p_lcl);
-    const QDomDocument* l_spawnDoc = getSpawnDoc(l_dt);
-    if (!l_spawnDoc) {
-        qWarning() << "(ling) [DomStorage] Data not found for locale" << p_lcl;
-        return QString::null;
+const bool DomStorage::spawnLocale(const QString& p_pth, QThreadPool* p_pool) {
+    QFile l_file(p_pth);
+
+    if (!l_file.exists () || !l_file.open (QIODevice::ReadOnly)) {
+        qWarning() << "(data) [DomStorage] Can't access" << p_pth << ".";
+        return false;
     }
 
-    const QDomElement l_dom = l_spawnDoc->documentElement ();
-    const QDomNodeList l_domList = l_dom.elementsByTagName ("Mapping").at (0).toElement ().elementsByTagName ("Suffix");
+    const QDir l_lclDir = QFileInfo(p_pth).absoluteDir ();
+    const QString l_mfstPth = l_lclDir.absoluteFilePath ("node.manifest");
+    Manifest l_mfst = loadManifest(l_mfstPth);
+    const QString l_srcHsh = hashOf(&l_file);
+
+    if (l_mfst.m_src == l_srcHsh && QFile::exists (l_lclDir.absoluteFilePath ("node.snapshot"))) {
+        qDebug() << "(data) [DomStorage]" << p_pth << "is unchanged; skipping it.";
+        return false;
+    }
 
-    for (int i = 0; i < l_domList.count (); i++) {
-        QDomElement l_ele = l_domList.at (i).toElement ();
+    l_mfst.m_src = l_srcHsh;
+    l_file.seek (0);
+    qDebug() << "(data) [DomStorage] Streaming" << p_pth << "...";
 
-        if (l_ele.attribute ("from") == p_sfx)
-            return l_ele.attribute ("to");
-        else
-            continue;
+    QStringList l_syms;
+    QList<const FlagList*> l_flgs;
+    NodeXmlReader l_rdr(&l_file);
+    QString l_sym;
+    QVariantMap l_mp;
+    while (l_rdr.next (l_sym,l_mp)) {
+        l_syms << l_sym;
+        l_flgs << FlagSets::intern (Node::toFlagList (l_mp));
     }
 
-    return "";
+    if (!l_rdr.hasError ()) {
+        spawn(l_rdr.locale (),l_syms,l_flgs,p_pool,l_mfstPth,l_mfst);
+        return true;
+    }
+
+    qWarning() << "(data) [DomStorage] Can't stream" << p_pth << ":" << l_rdr.errorString () << "; falling back to the DOM.";
+    l_file.seek (0);
+    QDomDocument l_spawnDom("Store");
+    if (!l_spawnDom.setContent (&l_file)) {
+        qWarning() << "(data) [DomStorage] Parse error in" << p_pth << ".";
+        return false;
+    }
+
+    spawn(l_spawnDom,p_pool,l_mfstPth,l_mfst);
+    return true;
 }
 
-void DomStorage::spawn(const QDomDocument& p_dom) {
+void DomStorage::spawn(const QDomDocument& p_dom, QThreadPool* p_pool, const QString& p_mfstPth, const Manifest& p_mfst) {
     const QDomElement l_root = p_dom.documentElement ();
-    const QString l_lcl = l_root.attribute ("locale");
     const QDomNodeList l_lst = l_root.elementsByTagName ("Data");
-    qDebug () << "(data) [DomStorage] Spawning locale" << l_lcl << "...";
 
+    // Symbols are read the way DomLoadModel reads them.
+    QStringList l_syms;
+    QList<const FlagList*> l_flgs;
     for (int i = 0; i < l_lst.count (); i++) {
-        QDomElement l_ele = l_lst.at (i).toElement ();
+        const QDomElement l_ele = l_lst.at (i).toElement ();
         if (l_ele.isNull ()) continue;
 
-        DomLoadModel l_ldM(&l_ele);
-        QDomDocument l_newDom("Data");
-        const Data* l_bsDt = l_ldM.load();
-        Data l_dt(l_bsDt->id (),l_lcl,l_bsDt->symbol (),l_bsDt->flags ());
+        QVariantMap l_mp;
+        const QDomNodeList l_ndlst = l_ele.childNodes ();
+        for (int j = 0; j < l_ndlst.count (); j++) {
+            const QDomElement l_flg = l_ndlst.at (j).toElement ();
+            l_mp.insert (l_flg.attribute ("guid"),l_flg.attribute ("link"));
+        }
 
-        QDomElement l_root = l_newDom.createElement ("Data");
-        l_root.setAttribute ("locale",l_lcl);
-        DomSaveModel l_svM(&l_root);
-        l_svM.saveFrom (l_dt);
-        l_newDom.appendChild (l_root);
+        l_syms << l_ele.attribute ("symbol").toLower ();
+        l_flgs << FlagSets::intern (Node::toFlagList (l_mp));
+    }
 
-        QFile* l_file = new QFile(DomStorage::getPath(l_dt));
+    spawn(l_root.attribute ("locale"),l_syms,l_flgs,p_pool,p_mfstPth,p_mfst);
+}
 
-        if (!l_file->open (QIODevice::WriteOnly | QIODevice::Truncate)) {
-            l_file->setPermissions(QFile::WriteOther);
-            //qWarning() << "(data) [DomStorage] Failed to spawn node" << l_dt.id() << ":" << l_file->errorString();
-        }
-        else {
-            QDataStream l_stream(l_file);
-            l_stream << "<!-- Generated -->" << endl
-            << l_newDom.toByteArray(4);
-            l_file->close ();
-            //qDebug() << "(data) [DomStorage] Wrote" << l_dt.id() << "with" << l_file->size() << "bytes.";
-        }
+void DomStorage::spawn(const QString& p_lcl, const QStringList& p_syms, const QList<const FlagList*>& p_flgs, QThreadPool* p_pool,
+                       const QString& p_mfstPth, const Manifest& p_mfst) {
+    // This runs on the spawning pool, so paths come from the manifest's; see System::setThreadDirectory().
+    const QDir l_lclDir = QFileInfo(p_mfstPth).absoluteDir ();
+    const QString l_dir = l_lclDir.absoluteFilePath ("node") + QString("/");
+    QList<Node> l_nodes, l_chngd;
+    QHash<NodeId, int> l_last;
+    const Atom l_lclAtm = Atoms::intern (p_lcl);
+    qDebug () << "(data) [DomStorage] Spawning locale" << p_lcl << "...";
+
+    // The IDs are hashed in one batch.
+    NodeIdList l_ids;
+    NodeId::fromSymbols (p_syms,l_ids);
+    for (int i = 0; i < l_ids.count (); i++) {
+        l_last.insert (l_ids.at (i),l_nodes.count ());
+        l_nodes << Node(l_ids.at (i),l_lclAtm,p_syms.at (i),p_flgs.at (i));
+    }
+
+    // Only the last definition of a symbol is spawned, and only if it differs from the last spawn.
+    QSharedPointer<DomSpawnJob> l_job(new DomSpawnJob(p_mfstPth));
+    l_job->m_mfst.m_src = p_mfst.m_src;
+
+    for (int i = 0; i < l_nodes.count (); i++) {
+        const Node& l_nd = l_nodes.at (i);
+        if (l_last.value (l_nd.nodeId ()) != i) continue;
+
+        const QString l_hsh = hashOf(l_nd);
+        l_job->m_mfst.m_ents.insert (l_nd.id (),l_hsh);
+        if (p_mfst.m_ents.value (l_nd.id ()) != l_hsh)
+            l_chngd << l_nd;
+    }
+
+    int l_rmvd = 0;
+    QHash<QString, QString>::ConstIterator l_itr = p_mfst.m_ents.constBegin (), l_end = p_mfst.m_ents.constEnd ();
+    for (; l_itr != l_end; ++l_itr) {
+        if (!l_job->m_mfst.m_ents.contains (l_itr.key ()) && QFile::remove (l_dir + l_itr.key () + QString(".node")))
+            l_rmvd++;
+    }
+
+    // Until every chunk lands, a crash must force a full spawn next time.
+    QFile::remove (p_mfstPth);
+    QDir().mkpath (l_dir);
+    Snapshot::write (l_lclDir.absoluteFilePath ("node.snapshot"), l_nodes);
+
+    l_job->m_left = (l_chngd.count () + DOMSTORAGE_SPAWN_CHUNK - 1) / DOMSTORAGE_SPAWN_CHUNK;
+    if (l_chngd.isEmpty ())
+        saveManifest(p_mfstPth,l_job->m_mfst);
+
+    for (int i = 0; i < l_chngd.count (); i += DOMSTORAGE_SPAWN_CHUNK)
+        p_pool->start (new DomSpawnTask(l_dir, l_chngd.mid (i,DOMSTORAGE_SPAWN_CHUNK), l_job));
+
+    qDebug () << "(data) [DomStorage] Locale" << p_lcl << "queued" << l_chngd.count () << "of" << l_job->m_mfst.m_ents.count ()
+              << "nodes and removed" << l_rmvd << ".";
+}
+
+void DomStorage::spawnNode(const QString& p_dir, const Data& p_dt) {
+    QFile l_file(p_dir + p_dt.id () + QString(".node"));
+
+    if (!l_file.open (QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "(data) [DomStorage] Failed to spawn node" << p_dt.id() << ":" << l_file.errorString();
+        return;
+    }
+
+    QXmlStreamWriter l_wrtr(&l_file);
+    l_wrtr.setAutoFormatting (true);
+    l_wrtr.setAutoFormattingIndent (4);
+    l_wrtr.writeStartDocument ();
+    l_wrtr.writeComment ("Generated");
+    l_wrtr.writeStartElement ("Data");
+    l_wrtr.writeAttribute ("locale",p_dt.locale ());
+    l_wrtr.writeAttribute ("symbol",p_dt.symbol ().toLower ());
+
+    const QVariantMap l_flgs = p_dt.flags ();
+    for (QVariantMap::ConstIterator l_itr = l_flgs.constBegin (); l_itr != l_flgs.constEnd (); ++l_itr) {
+        l_wrtr.writeEmptyElement ("Flag");
+        l_wrtr.writeAttribute ("guid",l_itr.key ());
+        l_wrtr.writeAttribute ("link",l_itr.value ().toString ());
     }
 
-    qDebug () << "(data) [DomStorage] Locale" << l_lcl << "spawned.";
+    l_wrtr.writeEndElement ();
+    l_wrtr.writeEndDocument ();
 }
 
 QDomDocument* DomStorage::getSpawnDoc(const Data& p_dt) {
@@ -385,26 +739,87 @@ QDomDocument* DomStorage::getSpawnDoc(const Data& p_dt) {
     return l_spawnDom;
 }
 
+const DomStorage::Template DomStorage::obtainTemplate(const QString& p_lcl) {
+    const QString l_pth = System::directory () + "/" + p_lcl + "/node.xml";
+    const QDateTime l_mtm = QFileInfo(l_pth).lastModified ();
+
+    {
+        QMutexLocker l_lck(&s_tmplMtx);
+        QHash<QString, Template>::ConstIterator l_itr = s_tmpls.constFind (l_pth);
+        if (l_itr != s_tmpls.constEnd () && l_itr.value ().m_mtm == l_mtm)
+            return l_itr.value ();
+    }
+
+    Template l_tmpl;
+    l_tmpl.m_mtm = l_mtm;
+    l_tmpl.m_hasPsd = false;
+
+    QFile l_file(l_pth);
+    if (l_file.open (QIODevice::ReadOnly)) {
+        NodeXmlReader l_rdr(&l_file);
+        l_rdr.readTemplate ();
+
+        if (!l_rdr.hasError ()) {
+            l_tmpl.m_hasPsd = l_rdr.hasPseudo ();
+            l_tmpl.m_psdFlg = l_rdr.pseudoFlags ();
+            l_tmpl.m_sfx = l_rdr.suffixes ();
+
+            QMutexLocker l_lck(&s_tmplMtx);
+            s_tmpls.insert (l_pth,l_tmpl);
+            return l_tmpl;
+        }
+
+        qWarning() << "(data) [DomStorage] Can't stream" << l_pth << ":" << l_rdr.errorString () << "; falling back to the DOM.";
+    }
+
+    const Data l_dt(QString::null,p_lcl);
+    QDomDocument* l_dom = getSpawnDoc(l_dt);
+
+    if (l_dom) {
+        const QDomElement l_root = l_dom->documentElement ();
+        QDomElement l_psElem = l_root.elementsByTagName ("Pseudo").at (0).toElement ();
+
+        if (!l_psElem.isNull ()) {
+            Data l_psDt;
+            DomLoadModel l_ldMdl(&l_psElem);
+            l_tmpl.m_hasPsd = l_ldMdl.loadTo (l_psDt);
+            l_tmpl.m_psdFlg = l_psDt.flags ();
+        }
+
+        const QDomNodeList l_sfxLst = l_root.elementsByTagName ("Mapping").at (0).toElement ().elementsByTagName ("Suffix");
+        for (int i = 0; i < l_sfxLst.count (); i++) {
+            const QDomElement l_ele = l_sfxLst.at (i).toElement ();
+            const QString l_from = l_ele.attribute ("from");
+            if (!l_tmpl.m_sfx.contains (l_from))
+                l_tmpl.m_sfx.insert (l_from,l_ele.attribute ("to"));
+        }
+
+        delete l_dom;
+    }
+
+    QMutexLocker l_lck(&s_tmplMtx);
+    s_tmpls.insert (l_pth,l_tmpl);
+    return l_tmpl;
+}
+
+void DomStorage::clearTemplates() {
+    QMutexLocker l_lck(&s_tmplMtx);
+    s_tmpls.clear ();
+}
+
 const bool DomStorage::hasPseudo(const Data& p_dt) const {
-    QDomDocument* l_dom = getSpawnDoc(p_dt);
-    QDomElement l_root = l_dom->documentElement ();
-    QDomNodeList l_lst = l_root.elementsByTagName ("Pseudo");
-    return !l_lst.isEmpty ();
+    return obtainTemplate(p_dt.locale ()).m_hasPsd;
 }
 
 void DomStorage::loadPseudo(Data& p_dt) const {
-    if (!hasPseudo(p_dt))
+    const Template l_tmpl = obtainTemplate(p_dt.locale ());
+    if (!l_tmpl.m_hasPsd)
         return;
 
-    QDomDocument* l_dom = getSpawnDoc(p_dt);
-    QDomElement l_root = l_dom->documentElement (), l_psElem;
-    QDomNodeList l_lst = l_root.elementsByTagName ("Pseudo");
-    l_psElem = l_lst.at (0).toElement ();
-
-    DomLoadModel l_ldMdl(&l_psElem);
+    // Only the flags are taken from the pseudo node; the symbol (and thus the ID) stays put.
     const QString l_sym = p_dt.symbol ();
-    l_ldMdl.loadTo (p_dt);
-    p_dt.setSymbol (l_sym); // The loading process probably overwrote the symbol; depends on the definition.
+    p_dt.setFlags (l_tmpl.m_psdFlg);
+    p_dt.setSymbol (l_sym);
 }
 
 /// @todo Allow a means of slowing this process down (very system intenstive, depends heavily on backend's speed).
@@ -513,7 +928,8 @@ void DomSaveModel::saveFrom(const Data& p_dt) {
 }
 
 const QString Cache::obtainFullSuffix(const QString& p_lcl, const QString& p_sfx) {
-    foreach (Storage* l_str, Cache::s_stores) {
+    const GenerationPointer l_gen = use(p_lcl);
+    foreach (Storage* l_str, l_gen->m_stores) {
         const QString l_fl = l_str->obtainFullSuffix(p_lcl,p_sfx);
         if (!l_fl.isEmpty ())
             return l_fl;
@@ -523,75 +939,878 @@ const QString Cache::obtainFullSuffix(const QString& p_lcl, const QString& p_sfx
     return "";
 }
 
+/// @note When a journaled storage's registered, writes land there alone; the others are rebuilt from it.
+const Cache::StorageList Cache::writers(const StorageList& p_strs) {
+    StorageList l_jrnld;
+    foreach (Storage* l_str, p_strs) {
+        if (l_str->isJournaled ())
+            l_jrnld << l_str;
+    }
+
+    return l_jrnld.isEmpty () ? p_strs : l_jrnld;
+}
+
+/// @note Writes hold off reload(), so the generation can't change under this.
+void Cache::learn (const Data &p_dt) {
+    forget(p_dt);
+
+    const GenerationPointer l_gen = current();
+    QWriteLocker l_lck(&s_fltrsLck);
+    QHash<QString, BloomFilter>::Iterator l_itr = l_gen->m_fltrs.find (p_dt.locale ());
+    if (l_itr != l_gen->m_fltrs.end ())
+        l_itr.value ().insert (p_dt.nodeId ());
+}
+
 /// @todo Consider allowing the developer to specify where they'd like to save information.
-void Cache::write (const Data &p_dt) {
-    if (!Cache::s_stores.empty()) {
-        foreach (Storage* l_str, Cache::s_stores)
-        l_str->saveFrom (p_dt);
-    } else {
-        DomStorage *l_domStr = new DomStorage;
-        l_domStr->saveFrom (p_dt);
-        delete l_domStr;
+const bool Cache::write (const Data &p_dt) {
+    QList<Data> l_nodes;
+    l_nodes << p_dt;
+    return commit(l_nodes,Storage::DurabilityFlush,CACHE_TALLY_INTERVAL);
+}
+
+const bool Cache::writeBatch (const QList<Data> &p_nodes, const Storage::Durability p_drblty) {
+    if (p_nodes.isEmpty ())
+        return true;
+
+    if (!commit(p_nodes,p_drblty,p_drblty == Storage::DurabilityNone ? CACHE_TALLY_INTERVAL : 1))
+        return false;
+
+    qDebug() << "(data) [Cache] Committed a batch of" << p_nodes.count () << "nodes.";
+    return true;
+}
+
+/// @note The copies being replaced are read from the writing storages alone (which see every node
+///       when they're journaled), in one pass and without going through the memory tier.
+const bool Cache::commit (const QList<Data> &p_nodes, const Storage::Durability p_drblty, const int p_tllMin) {
+    QReadLocker l_rldLck(&s_rldLck);
+    const GenerationPointer l_gen = current();
+    StorageList l_wrtrs = writers (l_gen->m_stores);
+    DomStorage* l_domStr = NULL;
+    if (l_wrtrs.isEmpty ())
+        l_wrtrs << (l_domStr = new DomStorage);
+
+    // Read-old, save and recount form one step; two writes of a node mustn't interleave within it.
+    QMutexLocker l_wrtLck(&s_wrtMtx);
+    QList<Data> l_olds;
+    QVector<bool> l_fnd(p_nodes.count (),false);
+    QSet<QString> l_lcls;
+    foreach (const Data& l_dt, p_nodes)
+    l_olds << Data(Node(l_dt.nodeId (),l_dt.node ().localeAtom (),QString(),NULL));
+
+    foreach (const Storage* l_str, l_wrtrs)
+    l_str->loadBatch (l_olds,l_fnd);
+
+    // The tallies are loaded before the nodes land, and stay marked dirty until they're saved past them.
+    foreach (const Data& l_dt, p_nodes)
+    l_lcls << l_dt.locale ();
+
+    foreach (const QString& l_lcl, l_lcls) {
+        tally(l_lcl);
+        Tally::markDirty (Tally::getPath (l_lcl));
+    }
+
+    bool l_ok = true;
+    foreach (Storage* l_str, l_wrtrs) {
+        if (!l_str->saveBatch (p_nodes,p_drblty)) {
+            qWarning() << "(data) [Cache]" << l_str->type () << "failed to save a batch of" << p_nodes.count () << "nodes.";
+            l_ok = false;
+        }
+    }
+
+    delete l_domStr;
+
+    // Whatever did land mustn't be shadowed by the copies held in memory, nor go uncounted;
+    // the locales' tallies (still marked dirty) and indexes are dropped and rebuilt when next used.
+    if (!l_ok) {
+        foreach (const Data& l_dt, p_nodes)
+        forget(l_dt);
+
+        {
+            QMutexLocker l_lck(&s_tllsMtx);
+            foreach (const QString& l_lcl, l_lcls)
+            s_tlls.remove (l_lcl);
+        }
+
+        QWriteLocker l_lck(&s_idxsLck);
+        foreach (const QString& l_lcl, l_lcls)
+        s_idxs.remove (l_lcl);
+
+        return false;
+    }
+
+    recount(l_olds,l_fnd,p_nodes);
+    foreach (const Data& l_dt, p_nodes)
+    learn(l_dt);
+
+    saveTallies(p_tllMin);
+    return true;
+}
+
+const bool Cache::mightExist(const GenerationPointer& p_gen, const Data& p_dt, bool& p_fltrd) {
+    QReadLocker l_lck(&s_fltrsLck);
+    QHash<QString, BloomFilter>::ConstIterator l_itr = p_gen->m_fltrs.constFind (p_dt.locale ());
+    p_fltrd = (l_itr != p_gen->m_fltrs.constEnd ());
+    if (!p_fltrd)
+        return true;
+
+    s_fltrQrs.ref ();
+    if (l_itr.value ().mightContain (p_dt.nodeId ()))
+        return true;
+
+    s_fltrRjcts.ref ();
+    return false;
+}
+
+const QHash<QString, BloomFilter> Cache::buildFilters(const StorageList& p_strs) {
+    QHash<QString, BloomFilter> l_fltrs;
+
+    foreach (const QString l_lcl, System::locales ()) {
+        BloomFilter l_fltr;
+        if (buildFilter(p_strs,l_lcl,l_fltr))
+            l_fltrs.insert (l_lcl,l_fltr);
+    }
+
+    return l_fltrs;
+}
+
+const bool Cache::buildFilter(const StorageList& p_strs, const QString& p_lcl, BloomFilter& p_fltr) {
+    NodeIdList l_ids;
+    if (p_strs.isEmpty ())
+        return false;
+
+    foreach (const Storage* l_str, p_strs) {
+        if (!l_str->nodes (p_lcl,l_ids)) {
+            qDebug() << "(data) [Cache] Storage" << l_str->type () << "can't list its nodes; not filtering" << p_lcl << ".";
+            return false;
+        }
+    }
+
+    // Leave some headroom for the nodes that'll be written before the next generate().
+    qSort(l_ids);
+    l_ids.erase (std::unique(l_ids.begin (),l_ids.end ()),l_ids.end ());
+    p_fltr = BloomFilter(l_ids.count () + (l_ids.count () / 4) + 1024);
+    foreach (const NodeId& l_id, l_ids)
+    p_fltr.insert (l_id);
+
+    qDebug() << "(data) [Cache] Filtering" << p_fltr.count () << "nodes of" << p_lcl << "with" << p_fltr.bits () << "bits.";
+    return true;
+}
+
+const QVariantMap Cache::statistics() {
+    QVariantMap l_stats, l_fltrStats;
+    const GenerationPointer l_gen = current();
+    l_stats["Directory"] = l_gen->m_dir;
+
+    {
+        // Each loaded locale's reported with the number of seconds it's been idle.
+        QVariantMap l_lclStats;
+        const uint l_now = QDateTime::currentDateTime ().toTime_t ();
+        QReadLocker l_lck(&s_lclsLck);
+        for (QHash<QString, uint>::ConstIterator l_itr = l_gen->m_lcls.constBegin (); l_itr != l_gen->m_lcls.constEnd (); ++l_itr)
+            l_lclStats.insert (l_itr.key (),(int) (l_now - qMin(l_itr.value (),l_now)));
+
+        l_stats["Locales"] = l_lclStats;
+        l_stats["LocaleLimit"] = WNTRDATA_LOCALE_LIMIT;
+    }
+
+    {
+        QReadLocker l_lck(&s_fltrsLck);
+        QHash<QString, BloomFilter>::ConstIterator l_itr = l_gen->m_fltrs.constBegin (), l_end = l_gen->m_fltrs.constEnd ();
+        for (; l_itr != l_end; ++l_itr) {
+            QVariantMap l_fltr;
+            l_fltr["Nodes"] = l_itr.value ().count ();
+            l_fltr["Bits"] = l_itr.value ().bits ();
+            l_fltr["Hashes"] = l_itr.value ().hashes ();
+            l_fltr["FalsePositiveRate"] = l_itr.value ().falsePositiveRate ();
+            l_fltrStats.insert (l_itr.key (),l_fltr);
+        }
+    }
+
+    {
+        QMutexLocker l_lck(&s_nodesMtx);
+        l_stats["MemoryNodes"] = s_nodes.count ();
+        l_stats["MemoryCapacity"] = s_nodes.maxCost ();
     }
+
+    l_stats["InternedStrings"] = Atoms::count ();
+    l_stats["FlagSets"] = FlagSets::count ();
+
+    // Every rejection is a true negative, so the misses seen are rejections plus false positives.
+    const int l_qrs = s_fltrQrs, l_rjcts = s_fltrRjcts, l_fps = s_fltrFps;
+    l_stats["Filters"] = l_fltrStats;
+    l_stats["FilterQueries"] = l_qrs;
+    l_stats["FilterRejections"] = l_rjcts;
+    l_stats["FilterFalsePositives"] = l_fps;
+    {
+        QVariantMap l_tllStats;
+        QMutexLocker l_lck(&s_tllsMtx);
+        for (QHash<QString, Tally>::ConstIterator l_itr = s_tlls.constBegin (); l_itr != s_tlls.constEnd (); ++l_itr)
+            l_tllStats.insert (l_itr.key (),l_itr.value ().toMap ());
+
+        l_stats["Tallies"] = l_tllStats;
+    }
+
+    {
+        QVariantMap l_idxStats;
+        QReadLocker l_lck(&s_idxsLck);
+        for (QHash<QString, LocaleIndex>::ConstIterator l_itr = s_idxs.constBegin (); l_itr != s_idxs.constEnd (); ++l_itr)
+            l_idxStats.insert (l_itr.key (),l_itr.value ().toMap ());
+
+        l_stats["Indexes"] = l_idxStats;
+    }
+
+    l_stats["ProbeMode"] = (int) probeMode();
+    l_stats["ProbeTimeouts"] = (int) s_prbTmdOut;
+    l_stats["ObservedFalsePositiveRate"] = (l_rjcts + l_fps) > 0 ? ((double) l_fps / (double) (l_rjcts + l_fps)) : 0.0;
+    return l_stats;
+}
+
+const Cache::NodeKey Cache::nodeKey(const Data& p_dt) {
+    return qMakePair(p_dt.node ().localeAtom (),p_dt.nodeId ());
+}
+
+/// @note s_gen's only ever swapped while s_nodesMtx is held, so it can be compared here without s_genLck.
+///       A write that landed while the node was loaded may have been missed by it, so the node isn't kept then.
+void Cache::remember(const Data& p_dt, const GenerationPointer& p_gen, const int p_epch) {
+    QMutexLocker l_lck(&s_nodesMtx);
+    if (s_gen != p_gen || s_wrtEpch != p_epch)
+        return;
+
+    if (s_nodes.maxCost () > 0)
+        s_nodes.insert (nodeKey(p_dt), new Node(p_dt.node ()));
+}
+
+const bool Cache::recall(Data& p_dt, int* p_epch) {
+    QMutexLocker l_lck(&s_nodesMtx);
+    if (p_epch)
+        *p_epch = s_wrtEpch;
+
+    const Node* l_nd = s_nodes.object (nodeKey(p_dt));
+    if (!l_nd)
+        return false;
+
+    p_dt.setNode (*l_nd);
+    return true;
+}
+
+/// @note Writes forget a node only once it's stored, so moving the epoch here turns away any read that began before.
+void Cache::forget(const Data& p_dt) {
+    QMutexLocker l_lck(&s_nodesMtx);
+    s_wrtEpch++;
+    s_nodes.remove (nodeKey(p_dt));
+}
+
+void Cache::clearMemory() {
+    QMutexLocker l_lck(&s_nodesMtx);
+    s_nodes.clear ();
+    s_psds.clear ();
+}
+
+void Cache::setCapacity(const int p_cap) {
+    QMutexLocker l_lck(&s_nodesMtx);
+    s_nodes.setMaxCost (qMax(p_cap, 0));
+    qDebug() << "(data) [Cache] Keeping up to" << s_nodes.maxCost () << "nodes in memory.";
+}
+
+const int Cache::capacity() {
+    QMutexLocker l_lck(&s_nodesMtx);
+    return s_nodes.maxCost ();
 }
 
-/// @note Wintermute considers its local data to be stored to disk. Currently, DomStorage represents the local nodes.
 const int Cache::countFlags() {
-    return DomStorage::countFlags();
+    qint64 l_cnt = 0;
+    foreach (const QString l_lcl, System::locales ())
+    l_cnt += tally(l_lcl).flags ();
+
+    return (int) l_cnt;
 }
 
-/// @note Wintermute considers its local data to be stored to disk. Currently, DomStorage represents the local nodes.
 const int Cache::countSymbols() {
-    return DomStorage::countSymbols();
+    int l_cnt = 0;
+    foreach (const QString l_lcl, System::locales ())
+    l_cnt += tally(l_lcl).nodes ();
+
+    return l_cnt;
+}
+
+/// @note The cursor's the hexadecimal ID of the last node of the previous page; it only turns binary here.
+const QStringList Cache::scanNodes(const QString& p_lcl, const QString& p_crsr, const int p_lmt) {
+    bool l_ok = true;
+    const NodeId l_crsr = p_crsr.isEmpty () ? NodeId() : NodeId::fromHex (p_crsr,&l_ok);
+    if (!l_ok) {
+        qWarning() << "(data) [Cache] Malformed cursor" << p_crsr << "for" << p_lcl << ".";
+        return QStringList();
+    }
+
+    const int l_lmt = qMax(p_lmt,1);
+    const GenerationPointer l_gen = use(p_lcl);
+    NodeIdList l_ids;
+    bool l_pgd = false;
+
+    foreach (const Storage* l_str, l_gen->m_stores)
+    l_pgd |= l_str->scan (p_lcl,l_crsr,l_lmt,l_ids);
+
+    if (!l_pgd) {
+        qDebug() << "(data) [Cache] No storage can page through" << p_lcl << "; listing every node.";
+        DomStorage().nodes (p_lcl,l_ids);
+        NodeIdList l_aftr;
+        foreach (const NodeId& l_id, l_ids) {
+            if (l_crsr.isNull () || l_crsr < l_id)
+                l_aftr << l_id;
+        }
+
+        l_ids = l_aftr;
+    }
+
+    // Each storage's page is sorted on its own; merge them into one.
+    qSort(l_ids);
+    l_ids.erase (std::unique(l_ids.begin (),l_ids.end ()),l_ids.end ());
+
+    QStringList l_pg;
+    for (int i = 0; i < l_ids.count () && i < l_lmt; i++)
+        l_pg << l_ids.at (i).toHex ();
+
+    return l_pg;
+}
+
+const Tally Cache::tally(const QString& p_lcl) {
+    {
+        QMutexLocker l_lck(&s_tllsMtx);
+        QHash<QString, Tally>::ConstIterator l_itr = s_tlls.constFind (p_lcl);
+        if (l_itr != s_tlls.constEnd ())
+            return l_itr.value ();
+    }
+
+    Tally l_tll;
+    const QString l_pth = Tally::getPath (p_lcl);
+    if (Tally::isDirty (l_pth) || !Tally::load (l_pth,l_tll)) {
+        qDebug() << "(data) [Cache] No saved tally for" << p_lcl << "(or it's dirty); counting its nodes.";
+        l_tll = scanTally(current()->m_stores,p_lcl);
+        l_tll.save (l_pth);
+    }
+
+    // Another thread may have beaten us to it; theirs is just as good.
+    QMutexLocker l_lck(&s_tllsMtx);
+    if (!s_tlls.contains (p_lcl))
+        s_tlls.insert (p_lcl,l_tll);
+
+    return s_tlls.value (p_lcl);
+}
+
+const Tally Cache::scanTally(const StorageList& p_strs, const QString& p_lcl, LocaleIndex* p_idx) {
+    NodeIdList l_ids;
+    foreach (const Storage* l_str, p_strs)
+    l_str->nodes (p_lcl,l_ids);
+
+    qSort(l_ids);
+    l_ids.erase (std::unique(l_ids.begin (),l_ids.end ()),l_ids.end ());
+
+    // The memory tier and the probe pool are bypassed; this would only flush the one and swamp the other.
+    Tally l_tll;
+    const Atom l_lcl = Atoms::intern (p_lcl);
+    foreach (const NodeId& l_id, l_ids) {
+        Data l_dt(Node(l_id,l_lcl,QString(),NULL));
+        foreach (const Storage* l_str, p_strs) {
+            if (l_str->exists (l_dt)) {
+                l_str->loadTo (l_dt);
+                l_tll.add (l_dt.node ());
+                if (p_idx)
+                    p_idx->add (l_dt.node ());
+                break;
+            }
+        }
+    }
+
+    return l_tll;
+}
+
+void Cache::buildIndexes(const StorageList& p_strs, QHash<QString, Tally>& p_tlls, QHash<QString, LocaleIndex>& p_idxs) {
+    foreach (const QString l_lcl, System::locales ()) {
+        LocaleIndex l_idx;
+        Tally l_tll = scanTally(p_strs,l_lcl,&l_idx);
+        l_idx.freeze ();
+        l_tll.save (Tally::getPath (l_lcl));
+        p_tlls.insert (l_lcl,l_tll);
+        p_idxs.insert (l_lcl,l_idx);
+        qDebug() << "(data) [Cache] Tallied" << l_tll.nodes () << "nodes and" << l_tll.flags () << "flags of" << l_lcl << "and indexed" << l_idx.symbols ().count () << "symbols.";
+    }
+}
+
+void Cache::loadIndex(const QString& p_lcl) {
+    const GenerationPointer l_gen = use(p_lcl);
+    {
+        QReadLocker l_lck(&s_idxsLck);
+        if (s_idxs.contains (p_lcl))
+            return;
+    }
+
+    qDebug() << "(data) [Cache] No index for" << p_lcl << "; indexing its nodes.";
+    LocaleIndex l_idx;
+    scanTally(l_gen->m_stores,p_lcl,&l_idx);
+    l_idx.freeze ();
+
+    // Another thread may have beaten us to it; theirs is just as good.
+    QWriteLocker l_lck(&s_idxsLck);
+    if (!s_idxs.contains (p_lcl))
+        s_idxs.insert (p_lcl,l_idx);
+}
+
+static const QVariantMap entriesToMap(const SymbolTrie::EntryList& p_entrs) {
+    QVariantMap l_map;
+    foreach (const SymbolTrie::Entry& l_entr, p_entrs)
+    l_map.insert (l_entr.first,l_entr.second.toHex ());
+
+    return l_map;
+}
+
+const QVariantMap Cache::prefixSearch(const QString& p_lcl, const QString& p_pfx, const int p_lmt) {
+    loadIndex(p_lcl);
+
+    QReadLocker l_lck(&s_idxsLck);
+    return entriesToMap(s_idxs.value (p_lcl).symbols ().prefix (p_pfx,p_lmt));
+}
+
+const QVariantMap Cache::rangeSearch(const QString& p_lcl, const QString& p_frm, const QString& p_to, const int p_lmt) {
+    loadIndex(p_lcl);
+
+    QReadLocker l_lck(&s_idxsLck);
+    return entriesToMap(s_idxs.value (p_lcl).symbols ().range (p_frm,p_to,p_lmt));
+}
+
+const QVariantList Cache::fuzzySearch(const QString& p_lcl, const QString& p_wrd, const int p_dist, const int p_lmt) {
+    loadIndex(p_lcl);
+
+    FuzzyIndex::MatchList l_mtchs;
+    {
+        QReadLocker l_lck(&s_idxsLck);
+        l_mtchs = s_idxs.value (p_lcl).fuzzy ().search (p_wrd,p_dist,p_lmt);
+    }
+
+    QVariantList l_lst;
+    foreach (const FuzzyIndex::Match& l_mtch, l_mtchs) {
+        QVariantMap l_map;
+        l_map["Symbol"] = l_mtch.m_sym;
+        l_map["Id"] = l_mtch.m_id.toHex ();
+        l_map["Distance"] = l_mtch.m_dist;
+        l_lst << l_map;
+    }
+
+    return l_lst;
+}
+
+const QVariantMap Cache::linkSearch(const QString& p_lcl, const QString& p_code, const bool p_pfx, const int p_lmt) {
+    loadIndex(p_lcl);
+
+    QVariantMap l_map;
+    int l_lft = p_lmt;
+    QReadLocker l_lck(&s_idxsLck);
+    const LinkIndex l_lnks = s_idxs.value (p_lcl).links ();
+    const QStringList l_codes = p_pfx ? l_lnks.codes (p_code) : QStringList(p_code);
+
+    foreach (const QString l_code, l_codes) {
+        if (l_lft <= 0)
+            break;
+
+        const QVector<NodeId> l_ids = l_lnks.nodes (l_code);
+        if (l_ids.isEmpty ())
+            continue;
+
+        QStringList l_hex;
+        for (int i = 0; i < l_ids.count () && l_lft > 0; i++, l_lft--)
+            l_hex << l_ids.at (i).toHex ();
+
+        l_map.insert (l_code,l_hex);
+    }
+
+    return l_map;
+}
+
+const QVariantMap Cache::linkCodes(const QString& p_lcl, const QString& p_pfx) {
+    loadIndex(p_lcl);
+
+    QVariantMap l_map;
+    QReadLocker l_lck(&s_idxsLck);
+    const LinkIndex l_lnks = s_idxs.value (p_lcl).links ();
+    foreach (const QString l_code, l_lnks.codes (p_pfx))
+    l_map.insert (l_code,l_lnks.count (l_code));
+
+    return l_map;
+}
+
+/// @note Only the nearest symbol's tried; if its node can't be read after all (i.e.: a stale index), nothing is.
+const bool Cache::approximate(Data& p_dt, const int p_dist) {
+    if (p_dt.symbol ().isEmpty () || p_dist <= 0)
+        return false;
+
+    loadIndex(p_dt.locale ());
+
+    FuzzyIndex::MatchList l_mtchs;
+    {
+        QReadLocker l_lck(&s_idxsLck);
+        l_mtchs = s_idxs.value (p_dt.locale ()).fuzzy ().search (p_dt.symbol (),p_dist,1);
+    }
+
+    if (l_mtchs.isEmpty ())
+        return false;
+
+    Data l_dt(Node(l_mtchs.first ().m_id,p_dt.node ().localeAtom (),QString(),NULL));
+    if (!Cache::read (l_dt))
+        return false;
+
+    qDebug() << "(data) [Cache] Approximated" << p_dt.symbol () << "with" << l_dt.symbol () << "in" << p_dt.locale () << ".";
+    p_dt = l_dt;
+    return true;
+}
+
+void Cache::recount(const QList<Data>& p_olds, const QVector<bool>& p_fnd, const QList<Data>& p_nodes) {
+    // Later copies of a node in the same batch replace the earlier ones, not what's stored.
+    QHash<NodeKey, Data> l_bch;
+    QList<QPair<Data, Data> > l_chngs;
+    QList<bool> l_rplcs;
+
+    for (int i = 0; i < p_nodes.count (); i++) {
+        const Data& l_dt = p_nodes.at (i);
+        const NodeKey l_key = nodeKey(l_dt);
+        Data l_old(p_olds.at (i));
+        bool l_rplc = p_fnd.at (i);
+
+        if (l_bch.contains (l_key)) {
+            l_old = l_bch.value (l_key);
+            l_rplc = true;
+        }
+
+        l_chngs << qMakePair(l_old,l_dt);
+        l_rplcs << l_rplc;
+        l_bch.insert (l_key,l_dt);
+    }
+
+    {
+        QMutexLocker l_lck(&s_tllsMtx);
+        for (int i = 0; i < l_chngs.count (); i++) {
+            Tally& l_tll = s_tlls[l_chngs.at (i).second.locale ()];
+            if (l_rplcs.at (i))
+                l_tll.remove (l_chngs.at (i).first.node ());
+
+            l_tll.add (l_chngs.at (i).second.node ());
+        }
+    }
+
+    // Locales that haven't been indexed yet will pick the nodes up when they are.
+    QWriteLocker l_lck(&s_idxsLck);
+    for (int i = 0; i < l_chngs.count (); i++) {
+        QHash<QString, LocaleIndex>::Iterator l_itr = s_idxs.find (l_chngs.at (i).second.locale ());
+        if (l_itr == s_idxs.end ())
+            continue;
+
+        if (l_rplcs.at (i))
+            l_itr.value ().remove (l_chngs.at (i).first.node ());
+
+        l_itr.value ().add (l_chngs.at (i).second.node ());
+    }
+}
+
+void Cache::saveTallies(const int p_min) {
+    QMutexLocker l_lck(&s_tllsMtx);
+    for (QHash<QString, Tally>::Iterator l_itr = s_tlls.begin (); l_itr != s_tlls.end (); ++l_itr) {
+        if (l_itr.value ().changes () >= p_min)
+            l_itr.value ().save (Tally::getPath (l_itr.key ()));
+    }
+}
+
+/**
+ * @brief The shared state of one lookup spread across the storages.
+ * @class ProbeRound lexical.cpp "src/lexical.cpp"
+ */
+class ProbeRound {
+public:
+    enum { Pending = -1, Missed = 0, Found = 1, TimedOut = 2 };
+
+    QMutex m_mtx;
+    QWaitCondition m_cnd;
+    QVector<int> m_rslts;
+    int m_frst;
+    bool m_cncld;
+
+    explicit ProbeRound(const int p_cnt) : m_mtx(), m_cnd(), m_rslts(p_cnt, Pending), m_frst(-1), m_cncld(false) { }
+
+    void settle(const int p_indx, const bool p_fnd) {
+        QMutexLocker l_lck(&m_mtx);
+        // A probe that's already been timed out has no say anymore.
+        if (m_rslts.at (p_indx) != Pending)
+            return;
+
+        m_rslts[p_indx] = p_fnd ? Found : Missed;
+        if (p_fnd && m_frst == -1)
+            m_frst = p_indx;
+
+        m_cnd.wakeAll ();
+    }
+
+    const bool isCancelled() {
+        QMutexLocker l_lck(&m_mtx);
+        return m_cncld;
+    }
+};
+
+typedef QSharedPointer<ProbeRound> ProbeRoundPointer;
+
+static const bool probe(const Storage* p_str, const Data& p_dt, const bool p_psd) {
+    return p_psd ? p_str->hasPseudo (p_dt) : p_str->exists (p_dt);
+}
+
+/**
+ * @brief Probes a single storage on behalf of a ProbeRound.
+ * @class ProbeTask lexical.cpp "src/lexical.cpp"
+ */
+class ProbeTask : public QRunnable {
+private:
+    ProbeRoundPointer m_rnd;
+    const int m_indx;
+    const Cache::GenerationPointer m_gen; /**< Keeps the storage alive should the probe outlast its lookup. */
+    const Data m_dt;
+    const bool m_psd;
+
+public:
+    ProbeTask(const ProbeRoundPointer& p_rnd, const int p_indx, const Cache::GenerationPointer& p_gen, const Data& p_dt, const bool p_psd) :
+        QRunnable(), m_rnd(p_rnd), m_indx(p_indx), m_gen(p_gen), m_dt(p_dt), m_psd(p_psd) { }
+
+    virtual void run() {
+        // A probe that's been called off before it started leaves its storage alone.
+        if (m_rnd->isCancelled ())
+            m_rnd->settle (m_indx,false);
+        else
+            m_rnd->settle (m_indx,probe(m_gen->m_stores.at (m_indx),m_dt,m_psd));
+    }
+};
+
+Storage* Cache::locate(const GenerationPointer& p_gen, const Data& p_dt, const bool p_psd) {
+    const StorageList l_strs = p_gen->m_stores;
+    ProbeMode l_mode;
+    QVector<int> l_tmouts;
+
+    {
+        QMutexLocker l_lck(&s_prbMtx);
+        l_mode = s_prbMode;
+        foreach (const Storage* l_str, l_strs)
+        l_tmouts << s_prbTmouts.value (l_str->type (),WNTRDATA_PROBE_TIMEOUT);
+    }
+
+    // Writes only reach the journaled storages, so the others hold stale copies of what's written; they're never raced.
+    if (l_mode == ProbeFirstHit && writers (l_strs).count () != l_strs.count ())
+        l_mode = ProbePriority;
+
+    if (l_mode == ProbeSequential || l_strs.count () < 2) {
+        foreach (Storage* l_str, l_strs) {
+            if (probe(l_str,p_dt,p_psd))
+                return l_str;
+        }
+
+        return NULL;
+    }
+
+    // The first storage is typically the local one. Nothing can beat it by priority, so it's asked
+    // alone first and a hit never costs a dispatch; racing, it's probed here while the others run.
+    ProbeRoundPointer l_rnd(new ProbeRound(l_strs.count ()));
+    if (l_mode == ProbePriority) {
+        if (probe(l_strs.at (0),p_dt,p_psd))
+            return l_strs.at (0);
+
+        l_rnd->settle (0,false);
+    }
+
+    for (int i = 1; i < l_strs.count (); i++)
+        s_prbPool.start (new ProbeTask(l_rnd,i,p_gen,p_dt,p_psd));
+
+    if (l_mode == ProbeFirstHit)
+        l_rnd->settle (0,probe(l_strs.at (0),p_dt,p_psd));
+
+    QTime l_clk;
+    l_clk.start ();
+    QMutexLocker l_lck(&l_rnd->m_mtx);
+    QVector<int>& l_rslts = l_rnd->m_rslts;
+    int l_wnr = -1;
+
+    forever {
+        const int l_elpsd = l_clk.elapsed ();
+        int l_wait = -1;
+
+        for (int i = 0; i < l_rslts.count (); i++) {
+            if (l_rslts.at (i) != ProbeRound::Pending || l_tmouts.at (i) <= 0)
+                continue;
+
+            const int l_left = l_tmouts.at (i) - l_elpsd;
+            if (l_left <= 0) {
+                qDebug() << "(data) [Cache] Probe of" << l_strs.at (i)->type () << "timed out after" << l_tmouts.at (i) << "ms.";
+                l_rslts[i] = ProbeRound::TimedOut;
+                s_prbTmdOut.ref ();
+            } else
+                l_wait = (l_wait < 0) ? l_left : qMin(l_wait,l_left);
+        }
+
+        bool l_dn = true;
+        if (l_mode == ProbeFirstHit) {
+            l_wnr = l_rnd->m_frst;
+            l_dn = (l_wnr != -1 || !l_rslts.contains (ProbeRound::Pending));
+        } else {
+            // Only settle on a storage once every storage registered before it has answered.
+            for (int i = 0; i < l_rslts.count (); i++) {
+                if (l_rslts.at (i) == ProbeRound::Found) {
+                    l_wnr = i;
+                    break;
+                } else if (l_rslts.at (i) == ProbeRound::Pending) {
+                    l_dn = false;
+                    break;
+                }
+            }
+        }
+
+        if (l_dn)
+            break;
+
+        if (l_wait < 0)
+            l_rnd->m_cnd.wait (&l_rnd->m_mtx);
+        else
+            l_rnd->m_cnd.wait (&l_rnd->m_mtx,(unsigned long) l_wait);
+    }
+
+    l_rnd->m_cncld = true;
+    return (l_wnr == -1) ? NULL : l_strs.at (l_wnr);
+}
+
+void Cache::setProbeMode(const ProbeMode p_mode) {
+    QMutexLocker l_lck(&s_prbMtx);
+    s_prbMode = p_mode;
+}
+
+const Cache::ProbeMode Cache::probeMode() {
+    QMutexLocker l_lck(&s_prbMtx);
+    return s_prbMode;
+}
+
+void Cache::setTimeout(const QString& p_type, const int p_ms) {
+    QMutexLocker l_lck(&s_prbMtx);
+    s_prbTmouts.insert (p_type,qMax(p_ms,0));
+}
+
+const int Cache::timeout(const QString& p_type) {
+    QMutexLocker l_lck(&s_prbMtx);
+    return s_prbTmouts.value (p_type,WNTRDATA_PROBE_TIMEOUT);
 }
 
-/// @todo Find a way to call all of the storages in parallel and then kill all of the other ones when none (or one has) found information.
 const bool Cache::exists(const Data& p_dt) {
-    foreach (Storage* l_str, Cache::s_stores) {
-        if (l_str->exists (p_dt))
+    // Lookups answered from memory count as uses too; the locale's otherwise unloaded for being idle.
+    const GenerationPointer l_gen = use(p_dt.locale ());
+    {
+        QMutexLocker l_lck(&s_nodesMtx);
+        if (s_nodes.contains (nodeKey(p_dt)))
             return true;
     }
+
+    bool l_fltrd = false;
+    if (!mightExist(l_gen,p_dt,l_fltrd))
+        return false;
+
+    if (locate(l_gen,p_dt,false))
+        return true;
+
+    if (l_fltrd)
+        s_fltrFps.ref ();
+
     return false;
 }
 
-/// @todo Find a way to call all of the storages in parallel and then kill all of the other ones when none (or one has) found information.
 const bool Cache::read (Data &p_dt) {
-    foreach (Storage* l_str, Cache::s_stores) {
-        if (l_str->exists (p_dt)) {
-            l_str->loadTo (p_dt);
-            return true;
-        } else continue;
+    const GenerationPointer l_gen = use(p_dt.locale ());
+    int l_epch = 0;
+    if (recall(p_dt,&l_epch))
+        return true;
+
+    bool l_fltrd = false;
+    if (!mightExist(l_gen,p_dt,l_fltrd))
+        return false;
+
+    Storage* l_str = locate(l_gen,p_dt,false);
+    if (l_str) {
+        l_str->loadTo (p_dt);
+        remember(p_dt,l_gen,l_epch);
+        return true;
     }
+
+    if (l_fltrd)
+        s_fltrFps.ref ();
+
     return false;
 }
 
-/// @todo Find a way to call all of the storages in parallel and then kill all of the other ones when none (or one has) found information.
+static const Data readNode(const Data& p_dt) {
+    Data l_dt(p_dt);
+    Cache::read (l_dt);
+    return l_dt;
+}
+
+static const Data writeNode(const Data& p_dt) {
+    Cache::write (p_dt);
+    return p_dt;
+}
+
+const QFuture<Data> Cache::readAsync(const Data& p_dt) {
+    return Async::call (&readNode,p_dt);
+}
+
+const QFuture<bool> Cache::existsAsync(const Data& p_dt) {
+    return Async::call (&Cache::exists,p_dt);
+}
+
+/// @note The write holds off reload() on the pool thread just as it would on the caller's.
+const QFuture<Data> Cache::writeAsync(const Data& p_dt) {
+    return Async::call (&writeNode,p_dt);
+}
+
 void Cache::pseudo (Data &p_psDt) {
-    foreach (Storage* l_str, Cache::s_stores) {
-        if (l_str->hasPseudo (p_psDt)) {
-            l_str->loadPseudo(p_psDt);
+    const QString l_lcl = p_psDt.locale ();
+    const QString l_sym = p_psDt.symbol ();
+
+    {
+        QMutexLocker l_lck(&s_nodesMtx);
+        QHash<QString, Node>::ConstIterator l_itr = s_psds.constFind (l_lcl);
+        if (l_itr != s_psds.constEnd ()) {
+            Node l_nd(p_psDt.node ());
+            l_nd.setFlagList (l_itr.value ().flagList ());
+            l_nd.setSymbol (l_sym);
+            p_psDt.setNode (l_nd);
             return;
-        } else continue;
+        }
+    }
+
+    const GenerationPointer l_gen = use(l_lcl);
+    Storage* l_str = locate(l_gen,p_psDt,true);
+    if (l_str) {
+        l_str->loadPseudo(p_psDt);
+
+        QMutexLocker l_lck(&s_nodesMtx);
+        if (s_gen == l_gen)
+            s_psds.insert (l_lcl,p_psDt.node ());
     }
 }
 
-/// @todo Find a way to call all of the storages in parallel and then kill all of the other ones when none (or one has) found information.
 const bool Cache::isPseudo(const Data& p_dt) {
-    foreach (Storage* l_str, Cache::s_stores) {
-        if (l_str->hasPseudo (p_dt)) {
-            Data l_dt;
-            l_str->loadPseudo(l_dt);
-            return (l_dt.id () == p_dt.id () && l_dt.flags () == p_dt.flags ());
-        } else continue;
+    Data l_dt(QString::null,p_dt.locale (),p_dt.symbol ());
+    Cache::pseudo (l_dt);
+
+    {
+        QMutexLocker l_lck(&s_nodesMtx);
+        if (!s_psds.contains (p_dt.locale ()))
+            return false;
     }
 
-    return false;
+    return (l_dt.nodeId () == p_dt.nodeId () && l_dt.flags () == p_dt.flags ());
 }
 
 /// @todo Allow this to be configurable (adding to plug-in settings). Default would be 'DomStorage'.
 Storage* Cache::addStorage(Storage* p_str) {
     if (!hasStorage(p_str->type ())) {
-        s_stores << p_str;
+        QWriteLocker l_lck(&s_genLck);
+        s_gen->m_stores << p_str;
         qDebug() << "(data) [Cache] Added lexical cache backend" << p_str->type() << ".";
     }
 
@@ -600,15 +1819,20 @@ Storage* Cache::addStorage(Storage* p_str) {
 
 /// @todo Find a way to call all of the storages in parallel and then kill all of the other ones when none (or one has) found information.
 void Cache::clearStorage() {
-    foreach(Storage* l_str, s_stores)
-    delete l_str;
-
-    s_stores.clear ();
+    // Probes that were called off may still be running against the storages.
+    s_prbPool.waitForDone ();
+    saveTallies();
+
+    // The storages go with the last lookup still holding their generation.
+    GenerationPointer l_gen(new Generation);
+    l_gen->m_dir = current()->m_dir;
+    publish(l_gen,QHash<QString, Tally>(),QHash<QString, LocaleIndex>());
 }
 
 /// @todo Find a way to call all of the storages in parallel and then kill all of the other ones when none (or one has) found information.
 const bool Cache::hasStorage(const QString& p_strName) {
-    foreach (Storage* l_str, s_stores) {
+    const GenerationPointer l_gen = current();
+    foreach (Storage* l_str, l_gen->m_stores) {
         if (l_str->type () == p_strName)
             return true;
     }
@@ -618,7 +1842,8 @@ const bool Cache::hasStorage(const QString& p_strName) {
 
 /// @todo Find a way to call all of the storages in parallel and then kill all of the other ones when none (or one has) found information.
 Storage* Cache::storage(const QString& p_strName) {
-    foreach (Storage* l_str, s_stores) {
+    const GenerationPointer l_gen = current();
+    foreach (Storage* l_str, l_gen->m_stores) {
         if (l_str->type () == p_strName)
             return l_str;
     }
@@ -634,17 +1859,384 @@ const QStringList Cache::allNodes(const QString& p_lcl) {
 }
 
 /// @todo Find a way to call all of the storages in parallel and then kill all of the other ones when none (or one has) found information.
+/// @note Unlike preload(), this readies every locale installed.
 void Cache::generate() {
     qDebug() << "(data) [Cache] Dumping all data storages...";
+    QMutexLocker l_ldLck(&s_ldMtx);
+    const GenerationPointer l_gen = current();
+    clearMemory();
+
+    {
+        QWriteLocker l_lck(&s_genLck);
+        l_gen->m_dir = System::directory ();
+    }
 
-    foreach (Storage* l_str, Cache::s_stores) {
+    // Storages layered over the others (i.e.: snapshots over DOM) come first, so they refresh last.
+    for (int i = l_gen->m_stores.count () - 1; i >= 0; i--) {
+        Storage* l_str = l_gen->m_stores.at (i);
         qDebug() << "(data) [Cache] Dumping" << l_str->type ();
         l_str->generate();
     }
 
+    const QHash<QString, BloomFilter> l_fltrs = buildFilters(l_gen->m_stores);
+    {
+        QWriteLocker l_lck(&s_fltrsLck);
+        l_gen->m_fltrs = l_fltrs;
+    }
+
+    QHash<QString, Tally> l_tlls;
+    QHash<QString, LocaleIndex> l_idxs;
+    buildIndexes(l_gen->m_stores,l_tlls,l_idxs);
+
+    {
+        QMutexLocker l_lck(&s_tllsMtx);
+        s_tlls = l_tlls;
+    }
+
+    {
+        QWriteLocker l_lck(&s_idxsLck);
+        s_idxs = l_idxs;
+    }
+
+    {
+        const uint l_now = QDateTime::currentDateTime ().toTime_t ();
+        QWriteLocker l_lck(&s_lclsLck);
+        foreach (const QString l_lcl, l_tlls.keys ())
+        l_gen->m_lcls.insert (l_lcl,l_now);
+    }
+
     qDebug() << "(data) [Cache] Dumped data.";
 }
 
+Cache::Generation::~Generation() {
+    foreach (Storage* l_str, m_stores)
+    delete l_str;
+}
+
+const Cache::GenerationPointer Cache::current() {
+    QReadLocker l_lck(&s_genLck);
+    return s_gen;
+}
+
+const Cache::GenerationPointer Cache::use(const QString& p_lcl) {
+    const GenerationPointer l_gen = current();
+    if (p_lcl.isEmpty ())
+        return l_gen;
+
+    // Uses are only stamped to the second, so a busy locale takes the write lock once a second at most.
+    const uint l_now = QDateTime::currentDateTime ().toTime_t ();
+    bool l_ldd = false;
+    {
+        QReadLocker l_lck(&s_lclsLck);
+        QHash<QString, uint>::ConstIterator l_itr = l_gen->m_lcls.constFind (p_lcl);
+        if (l_itr != l_gen->m_lcls.constEnd ()) {
+            if (l_itr.value () == l_now)
+                return l_gen;
+
+            l_ldd = true;
+        }
+    }
+
+    if (!l_ldd) {
+        if (loadLocale(l_gen,p_lcl))
+            evict(l_gen);
+
+        return l_gen;
+    }
+
+    // It may have been unloaded in the meantime; stamping it wouldn't load it back.
+    QWriteLocker l_lck(&s_lclsLck);
+    QHash<QString, uint>::Iterator l_itr = l_gen->m_lcls.find (p_lcl);
+    if (l_itr != l_gen->m_lcls.end ())
+        l_itr.value () = l_now;
+
+    return l_gen;
+}
+
+const bool Cache::loadLocale(const GenerationPointer& p_gen, const QString& p_lcl) {
+    QMutexLocker l_ldLck(&s_ldMtx);
+    {
+        QReadLocker l_lck(&s_lclsLck);
+        if (p_gen->m_lcls.contains (p_lcl))
+            return true;
+    }
+
+    if (!QFileInfo(System::directory () + "/" + p_lcl).isDir ())
+        return false;
+
+    QTime l_clk;
+    l_clk.start ();
+    qDebug() << "(data) [Cache] Loading locale" << p_lcl << "...";
+
+    QHash<QString, BloomFilter> l_fltrs;
+    QHash<QString, Tally> l_tlls;
+    QHash<QString, LocaleIndex> l_idxs;
+    prepareLocale(p_gen->m_stores,p_lcl,l_fltrs,l_tlls,l_idxs);
+
+    {
+        QWriteLocker l_lck(&s_fltrsLck);
+        if (l_fltrs.contains (p_lcl))
+            p_gen->m_fltrs.insert (p_lcl,l_fltrs.value (p_lcl));
+        else
+            p_gen->m_fltrs.remove (p_lcl);
+    }
+
+    // The tallies and indexes belong to whichever generation's current; a replaced one's are left be.
+    if (p_gen == current()) {
+        if (l_tlls.contains (p_lcl)) {
+            QMutexLocker l_lck(&s_tllsMtx);
+            s_tlls.insert (p_lcl,l_tlls.value (p_lcl));
+        }
+
+        if (l_idxs.contains (p_lcl)) {
+            QWriteLocker l_lck(&s_idxsLck);
+            s_idxs.insert (p_lcl,l_idxs.value (p_lcl));
+        }
+    }
+
+    {
+        QWriteLocker l_lck(&s_lclsLck);
+        p_gen->m_lcls.insert (p_lcl,QDateTime::currentDateTime ().toTime_t ());
+    }
+
+    qDebug() << "(data) [Cache] Loaded locale" << p_lcl << "in" << l_clk.elapsed () << "ms.";
+    return true;
+}
+
+const bool Cache::prepareLocale(const StorageList& p_strs, const QString& p_lcl, QHash<QString, BloomFilter>& p_fltrs,
+                                QHash<QString, Tally>& p_tlls, QHash<QString, LocaleIndex>& p_idxs) {
+    bool l_chngd = false;
+
+    // Storages layered over the others (i.e.: snapshots over DOM) come first, so they refresh last.
+    for (int i = p_strs.count () - 1; i >= 0; i--)
+        l_chngd |= p_strs.at (i)->prepare (p_lcl);
+
+    BloomFilter l_fltr;
+    if (buildFilter(p_strs,p_lcl,l_fltr))
+        p_fltrs.insert (p_lcl,l_fltr);
+
+    // An unchanged locale's saved tally still holds, and its index is built when it's first searched.
+    if (l_chngd) {
+        LocaleIndex l_idx;
+        Tally l_tll = scanTally(p_strs,p_lcl,&l_idx);
+        l_idx.freeze ();
+        l_tll.save (Tally::getPath (p_lcl));
+        p_tlls.insert (p_lcl,l_tll);
+        p_idxs.insert (p_lcl,l_idx);
+    }
+
+    return l_chngd;
+}
+
+void Cache::unloadLocale(const GenerationPointer& p_gen, const QString& p_lcl) {
+    QMutexLocker l_ldLck(&s_ldMtx);
+    {
+        QWriteLocker l_lck(&s_lclsLck);
+        if (!p_gen->m_lcls.remove (p_lcl))
+            return;
+    }
+
+    {
+        QWriteLocker l_lck(&s_fltrsLck);
+        p_gen->m_fltrs.remove (p_lcl);
+    }
+
+    {
+        QMutexLocker l_lck(&s_tllsMtx);
+        QHash<QString, Tally>::Iterator l_itr = s_tlls.find (p_lcl);
+        if (l_itr != s_tlls.end ()) {
+            if (l_itr.value ().changes () > 0)
+                l_itr.value ().save (Tally::getPath (p_lcl));
+
+            s_tlls.erase (l_itr);
+        }
+    }
+
+    {
+        QWriteLocker l_lck(&s_idxsLck);
+        s_idxs.remove (p_lcl);
+    }
+
+    {
+        const Atom l_lcl = Atoms::intern (p_lcl);
+        QMutexLocker l_lck(&s_nodesMtx);
+        foreach (const NodeKey& l_key, s_nodes.keys ()) {
+            if (l_key.first == l_lcl)
+                s_nodes.remove (l_key);
+        }
+
+        s_psds.remove (p_lcl);
+    }
+
+    foreach (Storage* l_str, p_gen->m_stores)
+    l_str->release (p_lcl);
+
+    qDebug() << "(data) [Cache] Unloaded locale" << p_lcl << ".";
+}
+
+void Cache::evict(const GenerationPointer& p_gen) {
+    if (WNTRDATA_LOCALE_LIMIT <= 0)
+        return;
+
+    // A write may be underway on this very thread (it loads the locales it touches); it's not waited on.
+    if (!s_rldLck.tryLockForWrite ())
+        return;
+
+    const QStringList l_pnnd = System::preloads ();
+    forever {
+        QString l_oldst;
+        {
+            QReadLocker l_lck(&s_lclsLck);
+            if (p_gen->m_lcls.count () <= WNTRDATA_LOCALE_LIMIT)
+                break;
+
+            uint l_used = 0;
+            for (QHash<QString, uint>::ConstIterator l_itr = p_gen->m_lcls.constBegin (); l_itr != p_gen->m_lcls.constEnd (); ++l_itr) {
+                if (!l_pnnd.contains (l_itr.key ()) && (l_oldst.isEmpty () || l_itr.value () < l_used)) {
+                    l_oldst = l_itr.key ();
+                    l_used = l_itr.value ();
+                }
+            }
+        }
+
+        if (l_oldst.isEmpty ())
+            break;
+
+        qDebug() << "(data) [Cache] More than" << WNTRDATA_LOCALE_LIMIT << "locales are loaded; unloading" << l_oldst << ".";
+        unloadLocale(p_gen,l_oldst);
+    }
+
+    s_rldLck.unlock ();
+}
+
+void Cache::preload() {
+    const GenerationPointer l_gen = current();
+    {
+        QWriteLocker l_lck(&s_genLck);
+        l_gen->m_dir = System::directory ();
+    }
+
+    foreach (const QString l_lcl, System::preloads ()) {
+        if (!loadLocale(l_gen,l_lcl))
+            qWarning() << "(data) [Cache] Can't preload locale" << l_lcl << "; it isn't installed.";
+    }
+}
+
+const QStringList Cache::unloadIdle(const int p_idle) {
+    QWriteLocker l_wrtLck(&s_rldLck);
+    const GenerationPointer l_gen = current();
+    const QStringList l_pnnd = System::preloads ();
+    const uint l_now = QDateTime::currentDateTime ().toTime_t ();
+    QStringList l_idle;
+
+    {
+        QReadLocker l_lck(&s_lclsLck);
+        for (QHash<QString, uint>::ConstIterator l_itr = l_gen->m_lcls.constBegin (); l_itr != l_gen->m_lcls.constEnd (); ++l_itr) {
+            if (!l_pnnd.contains (l_itr.key ()) && l_now - qMin(l_itr.value (),l_now) >= (uint) qMax(p_idle,0))
+                l_idle << l_itr.key ();
+        }
+    }
+
+    foreach (const QString l_lcl, l_idle)
+    unloadLocale(l_gen,l_lcl);
+
+    return l_idle;
+}
+
+void Cache::publish(const GenerationPointer& p_gen, const QHash<QString, Tally>& p_tlls, const QHash<QString, LocaleIndex>& p_idxs) {
+    GenerationPointer l_old;
+
+    {
+        QMutexLocker l_nodesLck(&s_nodesMtx);
+        QWriteLocker l_lck(&s_genLck);
+        l_old = s_gen;
+        s_gen = p_gen;
+        s_nodes.clear ();
+        s_psds.clear ();
+    }
+
+    if (!p_gen->m_dir.isEmpty () && p_gen->m_dir != l_old->m_dir)
+        System::setDirectory (p_gen->m_dir);
+
+    {
+        QMutexLocker l_lck(&s_tllsMtx);
+        s_tlls = p_tlls;
+    }
+
+    {
+        QWriteLocker l_lck(&s_idxsLck);
+        s_idxs = p_idxs;
+    }
+}
+
+/// @note Only the locales loaded now (and those preloaded) are readied; the rest are loaded when first used.
+const bool Cache::reload(const QString& p_dir, const QList<Storage*>& p_strs) {
+    QMutexLocker l_rldLck(&s_rldMtx);
+    GenerationPointer l_gen(new Generation);
+    l_gen->m_dir = QDir(p_dir).absolutePath ();
+    l_gen->m_stores = p_strs;
+
+    QTime l_clk;
+    l_clk.start ();
+    qDebug() << "(data) [Cache] Building a new lexicon from" << l_gen->m_dir << "...";
+
+    // Lookups carry on against the current generation; writes wait, or the new one would miss them.
+    QWriteLocker l_wrtLck(&s_rldLck);
+    QMutexLocker l_ldLck(&s_ldMtx);
+    const GenerationPointer l_old = current();
+    foreach (Storage* l_str, l_old->m_stores)
+    l_str->settle ();
+
+    saveTallies();
+
+    QStringList l_lcls;
+    {
+        QReadLocker l_lck(&s_lclsLck);
+        l_lcls = l_old->m_lcls.keys ();
+    }
+
+    // Everything below resolves its paths against the new directory; no other thread does yet.
+    System::setThreadDirectory (l_gen->m_dir);
+    const QStringList l_avlbl = System::locales ();
+    if (l_avlbl.isEmpty ()) {
+        System::setThreadDirectory (QString());
+        qWarning() << "(data) [Cache] No locales found in" << l_gen->m_dir << "; keeping the current lexicon.";
+        return false;
+    }
+
+    l_lcls += System::preloads ();
+    QHash<QString, Tally> l_tlls;
+    QHash<QString, LocaleIndex> l_idxs;
+    const uint l_now = QDateTime::currentDateTime ().toTime_t ();
+    const bool l_sameDir = (l_gen->m_dir == l_old->m_dir);
+
+    foreach (const QString l_lcl, l_lcls) {
+        if (!l_avlbl.contains (l_lcl) || l_gen->m_lcls.contains (l_lcl))
+            continue;
+
+        // A locale whose nodes didn't change keeps its tally and index.
+        if (!prepareLocale(l_gen->m_stores,l_lcl,l_gen->m_fltrs,l_tlls,l_idxs) && l_sameDir) {
+            {
+                QMutexLocker l_lck(&s_tllsMtx);
+                if (s_tlls.contains (l_lcl))
+                    l_tlls.insert (l_lcl,s_tlls.value (l_lcl));
+            }
+
+            QReadLocker l_lck(&s_idxsLck);
+            if (s_idxs.contains (l_lcl))
+                l_idxs.insert (l_lcl,s_idxs.value (l_lcl));
+        }
+
+        l_gen->m_lcls.insert (l_lcl,l_now);
+    }
+
+    System::setThreadDirectory (QString());
+
+    publish(l_gen,l_tlls,l_idxs);
+    qDebug() << "(data) [Cache] Swapped in the lexicon of" << l_gen->m_dir << "after" << l_clk.elapsed () << "ms.";
+    return true;
+}
+
 } /** end namespace Lexical */
 }
 }
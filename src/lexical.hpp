@@ -26,12 +26,27 @@
 
 #include <QObject>
 #include <QList>
+#include <QVector>
 #include <QMultiMap>
+#include <QHash>
+#include <QCache>
+#include <QPair>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <QDateTime>
 #include <QDebug>
 #include <QtXml/QDomDocument>
 #include <QtDBus/QDBusMetaType>
 #include <QMetaType>
 #include "linguistics.hpp"
+#include "async.hpp"
+#include "filter.hpp"
+#include "tally.hpp"
+#include "index.hpp"
+#include "node.hpp"
 
 namespace Wintermute {
 namespace Data {
@@ -52,6 +67,9 @@ struct DomLoadModel;
 struct DomSaveModel;
 struct DomStorage;
 struct DomBackend;
+struct DomLocaleTask;
+struct DomSpawnTask;
+struct DomSpawnJob;
 
 /**
  * @brief The lexical POD (plain ol' data) format of linguistics parsing.
@@ -64,6 +82,8 @@ struct DomBackend;
  * its internal, workable type ("Aeon1#~" [en]).
  *
  * @note This class can be considered this a POD (<b>p</b>lain <b>o</b>l' <b>data format) of Wintermute.
+ * @note Data is the reflective wrapper over a Node; it's what gets serialized.
+ *       Code that only carries nodes around should hold a Node instead.
  * @class Data models.hpp "src/models.hpp"
  * @see QVariantMap
  */
@@ -80,11 +100,7 @@ struct Data : public QObject {
     Q_PROPERTY(const QString ID READ id WRITE setID)
     Q_PROPERTY(const QVariantMap Flags READ flags WRITE setFlags)
 
-    //private:
-    QString m_id;
-    QString m_lcl;
-    QString m_sym;
-    QVariantMap m_flg;
+    Node m_nd;
 
 public:
     /**
@@ -112,6 +128,13 @@ public:
      */
     Data(const Data&);
 
+    /**
+     * @brief Wraps a Node.
+     * @fn Data
+     * @param p_nd The Node to be wrapped.
+     */
+    explicit Data(const Node&);
+
     /**
      * @brief Equality operator.
      * @fn operator==
@@ -137,11 +160,17 @@ public:
     virtual ~Data();
 
     /**
-     * @brief Returns the ID of the node.
+     * @brief Returns the hexadecimal ID of the node.
      * @fn id
      */
     const QString id() const;
 
+    /**
+     * @brief Returns the ID of the node.
+     * @fn nodeId
+     */
+    const NodeId nodeId() const;
+
     /**
      * @brief Returns the locale of the Data.
      * @fn locale
@@ -160,6 +189,19 @@ public:
      */
     const QVariantMap flags() const;
 
+    /**
+     * @brief Returns the Node wrapped by the Data.
+     * @fn node
+     */
+    const Node& node() const;
+
+    /**
+     * @brief Changes the Node wrapped by the Data.
+     * @fn setNode
+     * @param p_nd The Node for the Data to wrap now.
+     */
+    void setNode( const Node& );
+
     /**
      * @brief Changes the symbol of the Data to p_dt.
      * @fn setSymbol
@@ -194,6 +236,13 @@ public:
      */
     static const QString idFromString(const QString);
 
+    /**
+     * @brief Obtains the IDs of many QStrings at once.
+     * @fn idsFromStrings
+     * @param p_syms The texts to be transformed into their proper IDs.
+     */
+    static const QStringList idsFromStrings(const QStringList&);
+
     static const Data Null; /**< Represents an empty set of data. */
 };
 
@@ -421,6 +470,15 @@ class Backend { };
  */
 class Storage : public virtual Backend {
 public:
+    /**
+     * @brief Represents how hard a batch of writes is pushed to disk before returning.
+     */
+    enum Durability {
+        DurabilityNone = 0, /**< Leave the writes buffered in-process. */
+        DurabilityFlush,    /**< Flush the writes to the operating system once per batch. */
+        DurabilitySync      /**< Flush the writes and sync them to the disk once per batch. */
+    };
+
     /**
      * @brief Null constructor.
      * @fn Storage
@@ -441,6 +499,12 @@ public:
      */
     explicit Storage(const Backend&);
 
+    /**
+     * @brief Deconstructor.
+     * @fn ~Storage
+     */
+    virtual ~Storage();
+
     /**
      * @brief Equality operator.
      * @fn operator ==
@@ -477,6 +541,25 @@ public:
      * @param
      */
     virtual void saveFrom(const Data&) = 0;
+
+    /**
+     * @brief Saves a batch of nodes in one pass.
+     * @fn saveBatch
+     * @param p_nodes The nodes to be saved.
+     * @param p_drblty How hard the batch is pushed to disk.
+     * @return false if the batch (or any part of it) wasn't saved.
+     * @note The default implementation saves each node with saveFrom(), which can't fail.
+     */
+    virtual const bool saveBatch(const QList<Data>&, const Durability = DurabilityFlush);
+
+    /**
+     * @brief Loads a batch of nodes in one pass.
+     * @fn loadBatch
+     * @param p_nodes The nodes to be filled.
+     * @param p_fnd Set to true for each node that's found; nodes already found are skipped.
+     * @note The default implementation loads each node with exists() and loadTo().
+     */
+    virtual void loadBatch(QList<Data>&, QVector<bool>&) const;
     /**
      * @brief
      *
@@ -506,6 +589,58 @@ public:
      * @param
      */
     virtual const QString obtainFullSuffix(const QString&, const QString&) const = 0;
+
+    /**
+     * @brief Lists the IDs of every node this Storage holds for a locale.
+     * @fn nodes
+     * @param p_lcl The locale in question.
+     * @param p_ids The list to append the IDs to.
+     * @return false if this Storage can't enumerate its nodes.
+     */
+    virtual const bool nodes(const QString&, NodeIdList&) const;
+
+    /**
+     * @brief Determines if this Storage journals writes durably on its own.
+     * @fn isJournaled
+     * @return true if Cache::write() should route writes here alone.
+     */
+    virtual const bool isJournaled() const;
+
+    /**
+     * @brief Lists a page of the IDs this Storage holds for a locale, in sorted order.
+     * @fn scan
+     * @param p_lcl The locale in question.
+     * @param p_aftr The ID to list after; the null ID lists from the beginning.
+     * @param p_lmt The most IDs to list.
+     * @param p_ids The list to append the IDs to.
+     * @return false if this Storage can't page through its nodes.
+     */
+    virtual const bool scan(const QString&, const NodeId&, const int, NodeIdList&) const;
+
+    /**
+     * @brief Waits for any work this Storage's doing in the background to finish.
+     * @fn settle
+     * @note Cache::reload() settles the storages it's about to leave behind, so the
+     *       new ones never open a file the old ones are still rewriting.
+     */
+    virtual void settle();
+
+    /**
+     * @brief Readies a single locale to be served, the way generate() readies all of them.
+     * @fn prepare
+     * @param p_lcl The locale in question.
+     * @return true if the locale's nodes changed since it was last readied.
+     * @note The default implementation does nothing and reports no change.
+     */
+    virtual const bool prepare(const QString&);
+
+    /**
+     * @brief Lets go of whatever this Storage keeps in memory for a locale.
+     * @fn release
+     * @param p_lcl The locale in question.
+     * @note The locale's prepared again before it's next served. The default implementation does nothing.
+     */
+    virtual void release(const QString&);
 };
 
 /**
@@ -519,14 +654,276 @@ class Cache {
     friend class Wintermute::Data::Linguistics::System;
     typedef QList<Storage*> StorageList;
 
+public:
+    /**
+     * @brief Represents how a lookup's spread across the storages.
+     */
+    enum ProbeMode {
+        ProbeSequential = 0, /**< Probe the storages one after another, in order of registration. */
+        ProbeFirstHit,       /**< Probe the storages at once; whichever finds the node first wins. Only for independent storages; behind a journaled one it acts as ProbePriority. */
+        ProbePriority        /**< Probe the first storage, then the rest at once; the earliest-registered storage that finds the node wins. The default. */
+    };
+
+    /**
+     * @brief One generation of the lexicon: the directory it was built from,
+     *        the storages serving it and the ID filters built over them.
+     *
+     * A lookup takes hold of the current generation once and sees it through,
+     * so reload() can swap a new one in without waiting on anybody. The old
+     * generation's storages are deleted once the last lookup holding it is done.
+     */
+    struct Generation {
+        QString m_dir;
+        StorageList m_stores;
+        QHash<QString, BloomFilter> m_fltrs; /**< Guarded by s_fltrsLck. */
+        QHash<QString, uint> m_lcls; /**< The locales loaded, and when each was last used; guarded by s_lclsLck. */
+        ~Generation();
+    };
+
+    typedef QSharedPointer<Generation> GenerationPointer;
+
 private:
-    static StorageList s_stores; /** Represents a listing of all of the Storages for the Lexical system. */
+    typedef QPair<Atom, NodeId> NodeKey; /**< Keys a node by its interned locale and its ID. */
+
+    static GenerationPointer s_gen; /**< Represents the generation of the lexicon being served. */
+    static QReadWriteLock s_genLck; /**< Guards s_gen; it's only held long enough to copy or swap the pointer. */
+    static QReadWriteLock s_rldLck; /**< Held by writes, and exclusively by reload() so no write lands on a generation being left behind. */
+    static QMutex s_rldMtx; /**< Keeps reloads from overlapping. */
+    static QReadWriteLock s_lclsLck; /**< Guards the loaded locales of every generation. */
+    static QMutex s_ldMtx; /**< Keeps locales from being loaded and unloaded at once. */
+    static QCache<NodeKey, Node> s_nodes; /**< Represents the decoded nodes kept in memory, keyed by locale and ID. */
+    static QHash<QString, Node> s_psds; /**< Represents the pseudo nodes of each locale. */
+    static QMutex s_nodesMtx; /**< Guards s_nodes, s_psds and s_wrtEpch. */
+    static int s_wrtEpch; /**< Counts the nodes dropped from s_nodes by writes; a read that sees it move keeps its node to itself. */
+    static QReadWriteLock s_fltrsLck; /**< Guards the filters of every generation. */
+    static QAtomicInt s_fltrQrs; /**< Counts the lookups answered by a filter. */
+    static QAtomicInt s_fltrRjcts; /**< Counts the lookups turned away by a filter. */
+    static QAtomicInt s_fltrFps; /**< Counts the lookups a filter let through that no storage held. */
+    static QThreadPool s_prbPool; /**< Runs the probes of the storages beyond the first. */
+    static QHash<QString, int> s_prbTmouts; /**< Represents the probe timeout of each storage type, in milliseconds. */
+    static ProbeMode s_prbMode; /**< Represents how lookups are spread across the storages. */
+    static QMutex s_prbMtx; /**< Guards s_prbTmouts and s_prbMode. */
+    static QAtomicInt s_prbTmdOut; /**< Counts the probes that overran their timeout. */
+    static QHash<QString, Tally> s_tlls; /**< Represents the running counts of each locale. */
+    static QMutex s_tllsMtx; /**< Guards s_tlls. */
+    static QMutex s_wrtMtx; /**< Held across a write's old copies, its save and its recount, so concurrent writes of a node don't skew the tallies. */
+    static QHash<QString, LocaleIndex> s_idxs; /**< Represents the in-memory indexes of each locale. */
+    static QReadWriteLock s_idxsLck; /**< Guards s_idxs. */
+
+    /**
+     * @brief Obtains the generation of the lexicon being served.
+     * @fn current
+     */
+    static const GenerationPointer current();
+
+    /**
+     * @brief Obtains the current generation, loading a locale into it first if need be.
+     * @fn use
+     * @param p_lcl The locale about to be used.
+     * @note This also marks the locale as used, which keeps it from being unloaded as idle.
+     */
+    static const GenerationPointer use(const QString& );
+
+    /**
+     * @brief Loads a locale into a generation, unless it's been loaded already.
+     * @fn loadLocale
+     * @param p_gen The generation in question.
+     * @param p_lcl The locale in question.
+     * @return false if there's no such locale.
+     */
+    static const bool loadLocale(const GenerationPointer&, const QString& );
+
+    /**
+     * @brief Prepares a locale in every storage and builds what's derived from it.
+     * @fn prepareLocale
+     * @param p_strs The storages to prepare.
+     * @param p_lcl The locale in question.
+     * @param p_fltrs The map to hold the locale's filter.
+     * @param p_tlls The map to hold the locale's tally.
+     * @param p_idxs The map to hold the locale's index.
+     * @return true if the locale's nodes changed; only then are its tally and index rebuilt here.
+     */
+    static const bool prepareLocale(const StorageList&, const QString&, QHash<QString, BloomFilter>&, QHash<QString, Tally>&, QHash<QString, LocaleIndex>&);
+
+    /**
+     * @brief Unloads a locale from a generation.
+     * @fn unloadLocale
+     * @param p_gen The generation in question.
+     * @param p_lcl The locale in question.
+     * @note The caller must hold s_rldLck for writing, so no write to the locale is underway.
+     */
+    static void unloadLocale(const GenerationPointer&, const QString& );
+
+    /**
+     * @brief Unloads the locales left idle the longest until no more than WNTRDATA_LOCALE_LIMIT remain.
+     * @fn evict
+     * @param p_gen The generation in question.
+     * @note This gives up if a write's underway; the next locale loaded tries again.
+     */
+    static void evict(const GenerationPointer& );
+
+    /**
+     * @brief Serves a generation of the lexicon from now on.
+     * @fn publish
+     * @param p_gen The generation in question.
+     * @param p_tlls The tallies built alongside it.
+     * @param p_idxs The indexes built alongside it.
+     * @note The memory tier's emptied in the same step, so nothing read from
+     *       the old generation outlives the swap.
+     */
+    static void publish(const GenerationPointer&, const QHash<QString, Tally>&, const QHash<QString, LocaleIndex>&);
+
+    /**
+     * @brief Counts every node of a locale by walking the storages.
+     * @fn scanTally
+     * @param p_strs The storages to walk.
+     * @param p_lcl The locale in question.
+     * @param p_idx If given, every node counted is indexed into it as well.
+     * @note This reads every node; it's meant for generate() and for locales without a saved tally or index.
+     */
+    static const Tally scanTally(const StorageList&, const QString&, LocaleIndex* = NULL);
+
+    /**
+     * @brief Rebuilds and saves the tally of every locale, and rebuilds its index in the same pass.
+     * @fn buildIndexes
+     * @param p_strs The storages to walk.
+     * @param p_tlls The map to hold the tallies.
+     * @param p_idxs The map to hold the indexes.
+     */
+    static void buildIndexes(const StorageList&, QHash<QString, Tally>&, QHash<QString, LocaleIndex>&);
+
+    /**
+     * @brief Builds the index of a locale, unless it's been built already.
+     * @fn loadIndex
+     * @param p_lcl The locale in question.
+     */
+    static void loadIndex(const QString& );
+
+    /**
+     * @brief Moves the tallies and indexes over to the nodes just written.
+     * @fn recount
+     * @param p_olds The copies the nodes replaced, as read before they were saved.
+     * @param p_fnd Whether or not each node had a copy to replace.
+     * @param p_nodes The nodes just written.
+     */
+    static void recount(const QList<Data>&, const QVector<bool>&, const QList<Data>&);
+
+    /**
+     * @brief Saves nodes to the writing storages, then counts and admits them.
+     * @fn commit
+     * @param p_nodes The nodes to be written.
+     * @param p_drblty How hard they're pushed to disk.
+     * @param p_tllMin The changes a tally has to hold before it's saved along.
+     * @return false if a storage failed to save them; their locales are recounted when next used then.
+     */
+    static const bool commit(const QList<Data>&, const Storage::Durability, const int);
+
+    /**
+     * @brief Saves every tally that's changed since it was last saved.
+     * @fn saveTallies
+     * @param p_min The number of changes a tally needs before it's saved.
+     */
+    static void saveTallies(const int = 1);
+
+    /**
+     * @brief Finds the storage that holds a node (or a pseudo node).
+     * @fn locate
+     * @param p_gen The generation whose storages are probed.
+     * @param p_dt The Data in question.
+     * @param p_psd Whether to look for the locale's pseudo node instead.
+     * @return The winning storage, or NULL if none holds it.
+     * @note The first storage is probed on the calling thread, the rest on s_prbPool.
+     *       Once a winner's known, the probes that haven't started are called off.
+     */
+    static Storage* locate(const GenerationPointer&, const Data&, const bool);
+
+    /**
+     * @brief Asks the locale's ID filter if a Data might be held by any storage.
+     * @fn mightExist
+     * @param p_gen The generation whose filters are asked.
+     * @param p_dt The Data in question.
+     * @param p_fltrd Set to true if a filter answered the question.
+     * @return false if the Data is definitely not held.
+     */
+    static const bool mightExist(const GenerationPointer&, const Data&, bool&);
+
+    /**
+     * @brief Builds the ID filter of every locale from the storages.
+     * @fn buildFilters
+     * @param p_strs The storages to build the filters from.
+     * @note A locale is left unfiltered if any storage can't list its nodes.
+     */
+    static const QHash<QString, BloomFilter> buildFilters(const StorageList&);
+
+    /**
+     * @brief Builds the ID filter of a locale from the storages.
+     * @fn buildFilter
+     * @param p_strs The storages to build the filter from.
+     * @param p_lcl The locale in question.
+     * @param p_fltr The filter to be built.
+     * @return false if any storage can't list the locale's nodes.
+     */
+    static const bool buildFilter(const StorageList&, const QString&, BloomFilter& );
+
+    /**
+     * @brief Obtains the storages that writes should land in.
+     * @fn writers
+     * @param p_strs The storages to choose from.
+     * @note Journaled storages take every write when present; otherwise all of them do.
+     */
+    static const StorageList writers(const StorageList&);
+
+    /**
+     * @brief Drops a written node from memory and admits it to its locale's filter.
+     * @fn learn
+     * @param p_dt The node that was written.
+     */
+    static void learn(const Data&);
+
+    /**
+     * @brief Obtains the key of a Data in the memory tier.
+     * @fn nodeKey
+     * @param p_dt The Data in question.
+     */
+    static const NodeKey nodeKey(const Data&);
+
+    /**
+     * @brief Keeps a decoded Data in the memory tier.
+     * @fn remember
+     * @param p_dt The Data to be kept.
+     * @param p_gen The generation it was read from; it's not kept if that's been replaced since.
+     * @param p_epch The write epoch taken by recall() before it was read; it's not kept if a write's landed since.
+     */
+    static void remember(const Data&, const GenerationPointer&, const int);
+
+    /**
+     * @brief Fills a Data from the memory tier, if it's held there.
+     * @fn recall
+     * @param p_dt The Data to be filled.
+     * @param p_epch Set to the current write epoch, to be handed to remember() after a miss.
+     */
+    static const bool recall(Data&, int* = NULL);
+
+    /**
+     * @brief Drops a Data from the memory tier.
+     * @fn forget
+     * @param p_dt The Data to be dropped.
+     */
+    static void forget(const Data&);
+
+    /**
+     * @brief Drops every node held by the memory tier.
+     * @fn clearMemory
+     */
+    static void clearMemory();
 
     /**
      * @brief
      *
      * @fn addStorage
      * @param
+     * @note Storages are added to the current generation in place; once the
+     *       lexicon's being served, reload() is how they're replaced.
      */
     static Storage* addStorage(Storage*);
     /**
@@ -552,6 +949,19 @@ private:
 
 public:
     ~Cache();
+    /**
+     * @brief Changes the number of decoded nodes kept in memory.
+     * @fn setCapacity
+     * @param p_cap The number of nodes; 0 disables the memory tier.
+     */
+    static void setCapacity(const int);
+
+    /**
+     * @brief Obtains the number of decoded nodes that can be kept in memory.
+     * @fn capacity
+     */
+    static const int capacity();
+
     /**
      * @brief
      *
@@ -564,8 +974,18 @@ public:
      *
      * @fn write
      * @param
+     * @return false if the node wasn't saved.
+     */
+    static const bool write( const Data & );
+    /**
+     * @brief Writes many nodes, committing them as one group.
+     *
+     * @fn writeBatch
+     * @param p_nodes The nodes to be written.
+     * @param p_drblty How hard the batch is pushed to disk.
+     * @return false if the batch wasn't saved.
      */
-    static void write( const Data & );
+    static const bool writeBatch( const QList<Data>&, const Storage::Durability = Storage::DurabilityFlush );
     /**
      * @brief
      *
@@ -573,6 +993,31 @@ public:
      * @param
      */
     static const bool exists( const Data& );
+
+    /**
+     * @brief Reads a node on the I/O pool.
+     * @fn readAsync
+     * @param p_dt The node to read; it's copied.
+     * @return The future of the node read; on a miss, the node's handed back as it was passed.
+     * @see Async::then
+     */
+    static const QFuture<Data> readAsync( const Data& );
+
+    /**
+     * @brief Determines if a node exists, on the I/O pool.
+     * @fn existsAsync
+     * @param p_dt The node in question; it's copied.
+     */
+    static const QFuture<bool> existsAsync( const Data& );
+
+    /**
+     * @brief Writes a node on the I/O pool.
+     * @fn writeAsync
+     * @param p_dt The node to write; it's copied.
+     * @return The future of the node written, finished once it's landed.
+     * @note Writes queued one after the other may land in any order; wait on the first to order them.
+     */
+    static const QFuture<Data> writeAsync( const Data& );
     /**
      * @brief
      *
@@ -595,19 +1040,141 @@ public:
     static void generate();
 
     /**
-     * @brief
+     * @brief Builds a new generation of the lexicon and swaps it in for the current one.
+     * @fn reload
+     * @param p_dir The directory to build it from.
+     * @param p_strs The storages to serve it; they're owned by the Cache from here on.
+     * @return false if the directory holds no locales; the current generation's kept then.
+     * @note Lookups carry on against the current generation while the new one's built,
+     *       and those already underway when it's swapped in finish against the old one.
+     *       Writes wait for the swap, so none of them is lost to the old generation.
+     */
+    static const bool reload(const QString&, const QList<Storage*>& );
+
+    /**
+     * @brief Loads the locales listed by System::preloads(); every other locale's loaded when first used.
+     * @fn preload
+     */
+    static void preload();
+
+    /**
+     * @brief Unloads the locales that have been idle for a while.
+     * @fn unloadIdle
+     * @param p_idle The number of seconds a locale must have been idle for.
+     * @return The locales unloaded.
+     * @note The locales listed by System::preloads() are never unloaded.
+     */
+    static const QStringList unloadIdle(const int);
+
+    /**
+     * @brief Counts the flags of every node of every locale.
      *
      * @fn countFlags
+     * @note This is read from the tallies; no node is read.
      */
     static const int countFlags();
 
     /**
-     * @brief
+     * @brief Counts the nodes of every locale.
      *
      * @fn countSymbols
+     * @note This is read from the tallies; no node is read.
      */
     static const int countSymbols();
 
+    /**
+     * @brief Obtains the running counts of a locale.
+     *
+     * @fn tally
+     * @param p_lcl The locale in question.
+     * @note A locale without a saved tally is scanned once, on first use.
+     */
+    static const Tally tally(const QString& = Wintermute::Data::Linguistics::System::locale ());
+
+    /**
+     * @brief Lists a page of the IDs of a locale's nodes, in sorted order.
+     *
+     * @fn scanNodes
+     * @param p_lcl The locale in question.
+     * @param p_crsr The cursor; the last ID of the previous page, or an empty string to start.
+     * @param p_lmt The most IDs to list.
+     * @note A page shorter than p_lmt is the last one. Only the storages that
+     *       can page (i.e.: SnapshotStorage, which indexes what DomStorage spawns)
+     *       are consulted; allNodes() is only fallen back on without any.
+     */
+    static const QStringList scanNodes(const QString&, const QString& = QString(), const int = 256);
+
+    /**
+     * @brief Lists the symbols of a locale that start with a prefix.
+     *
+     * @fn prefixSearch
+     * @param p_lcl The locale in question.
+     * @param p_pfx The prefix; it's matched regardless of case.
+     * @param p_lmt The most symbols to list.
+     * @return The symbols (in lower case) found, in sorted order, each mapped to the ID of its node.
+     * @note This is answered from the locale's index; no storage is read.
+     */
+    static const QVariantMap prefixSearch(const QString&, const QString&, const int = 256);
+
+    /**
+     * @brief Lists the symbols of a locale that sort within a range.
+     *
+     * @fn rangeSearch
+     * @param p_lcl The locale in question.
+     * @param p_frm The lower bound, inclusive.
+     * @param p_to The upper bound, exclusive; an empty one leaves the range open.
+     * @param p_lmt The most symbols to list.
+     * @return The symbols (in lower case) found, in sorted order, each mapped to the ID of its node.
+     * @note The bounds are compared in lower case, as the symbols are.
+     */
+    static const QVariantMap rangeSearch(const QString&, const QString&, const QString& = QString(), const int = 256);
+
+    /**
+     * @brief Lists the symbols of a locale within an edit distance of a word.
+     *
+     * @fn fuzzySearch
+     * @param p_lcl The locale in question.
+     * @param p_wrd The word in question; it's compared in lower case.
+     * @param p_dist The greatest distance to accept; it's capped at WNTRDATA_FUZZY_DISTANCE.
+     * @param p_lmt The most symbols to list.
+     * @return The symbols found, nearest first, each as a map of its "Symbol", "Id" and "Distance".
+     */
+    static const QVariantList fuzzySearch(const QString&, const QString&, const int = 1, const int = 16);
+
+    /**
+     * @brief Replaces a Data whose node isn't held with the nearest one that is.
+     *
+     * @fn approximate
+     * @param p_dt The Data in question; its symbol's the one looked up.
+     * @param p_dist The greatest edit distance to accept.
+     * @return false if no symbol lies within p_dist, leaving p_dt as it was.
+     * @note This is meant for after read() has missed; it's never tried by read() itself.
+     */
+    static const bool approximate(Data&, const int = 1);
+
+    /**
+     * @brief Lists the nodes of a locale whose flags carry a link code.
+     *
+     * @fn linkSearch
+     * @param p_lcl The locale in question.
+     * @param p_code The link code (i.e.: <tt>Aen1~</tt>); it's matched exactly, case and all.
+     * @param p_pfx Whether p_code's a prefix, matching every code that starts with it.
+     * @param p_lmt The most IDs to list, across every code matched.
+     * @return Each code matched, in sorted order, mapped to the sorted IDs of its nodes.
+     * @note This is answered from the locale's index; no storage is read.
+     */
+    static const QVariantMap linkSearch(const QString&, const QString&, const bool = false, const int = 256);
+
+    /**
+     * @brief Lists the link codes carried by the flags of a locale.
+     *
+     * @fn linkCodes
+     * @param p_lcl The locale in question.
+     * @param p_pfx The prefix of the codes to list; an empty one lists every code.
+     * @return Each code, in sorted order, mapped to the number of nodes carrying it.
+     */
+    static const QVariantMap linkCodes(const QString&, const QString& = QString());
+
     /**
      * @brief
      *
@@ -616,6 +1183,41 @@ public:
      */
     static const QStringList allNodes(const QString& = Wintermute::Data::Linguistics::System::locale ());
 
+    /**
+     * @brief Obtains statistics about the memory tier, the ID filters and the storage probes.
+     * @fn statistics
+     */
+    static const QVariantMap statistics();
+
+    /**
+     * @brief Changes how lookups are spread across the storages.
+     * @fn setProbeMode
+     * @param p_mode The mode to use.
+     */
+    static void setProbeMode(const ProbeMode);
+
+    /**
+     * @brief Obtains how lookups are spread across the storages.
+     * @fn probeMode
+     */
+    static const ProbeMode probeMode();
+
+    /**
+     * @brief Changes how long a concurrent probe of a storage is waited on.
+     * @fn setTimeout
+     * @param p_type The type of the storage in question.
+     * @param p_ms The timeout in milliseconds; 0 waits indefinitely.
+     * @note A probe that overruns its timeout counts as a miss.
+     */
+    static void setTimeout(const QString&, const int);
+
+    /**
+     * @brief Obtains how long a concurrent probe of a storage is waited on.
+     * @fn timeout
+     * @param p_type The type of the storage in question.
+     */
+    static const int timeout(const QString&);
+
     /**
      * @brief
      *
@@ -757,8 +1359,39 @@ public:
 class DomStorage : public Storage {
     friend class DomLoadModel;
     friend class DomSaveModel;
+    friend class DomLocaleTask;
+    friend class DomSpawnTask;
+    friend class DomSpawnJob;
 
 private:
+    /**
+     * @brief The parts of a locale's <tt>node.xml</tt> needed to resolve pseudo
+     *        nodes and suffixes, extracted once per parse.
+     */
+    struct Template {
+        QDateTime m_mtm; /**< The modification time of the parsed node.xml. */
+        bool m_hasPsd; /**< Whether or not the locale defines a pseudo node. */
+        QVariantMap m_psdFlg; /**< The flags of the pseudo node. */
+        QHash<QString, QString> m_sfx; /**< The suffix mappings, keyed by the 'from' suffix. */
+    };
+
+    static QHash<QString, Template> s_tmpls; /**< The templates, keyed by the path of their node.xml. */
+    static QMutex s_tmplMtx; /**< Guards s_tmpls. */
+
+    /**
+     * @brief Obtains the template of a locale, streaming its node.xml only when
+     *        it's not cached or the file changed on disk.
+     * @fn obtainTemplate
+     * @param p_lcl The locale in question.
+     */
+    static const Template obtainTemplate(const QString&);
+
+    /**
+     * @brief Drops all of the cached templates.
+     * @fn clearTemplates
+     */
+    static void clearTemplates();
+
     /**
      * @brief
      *
@@ -775,12 +1408,68 @@ private:
      */
     static QDomDocument* getSpawnDoc(const Data&);
     /**
-     * @brief
-     *
+     * @brief Records what was spawned for a locale, so that the next
+     *        generate() only rewrites what changed in its node.xml.
+     */
+    struct Manifest {
+        QString m_src; /**< The MD5 of the node.xml that was spawned. */
+        QHash<QString, QString> m_ents; /**< The content hash of each spawned node, keyed by ID. */
+    };
+
+    /**
+     * @brief Loads a manifest from disk; a missing manifest is empty.
+     * @fn loadManifest
+     * @param p_pth The path to the manifest.
+     */
+    static const Manifest loadManifest(const QString&);
+
+    /**
+     * @brief Saves a manifest to disk.
+     * @fn saveManifest
+     * @param p_pth The path to the manifest.
+     * @param p_mfst The manifest to be saved.
+     */
+    static void saveManifest(const QString&, const Manifest&);
+
+    /**
+     * @brief Streams a locale's node.xml and spawns its nodes.
+     * @fn spawnLocale
+     * @param p_pth The path to the locale's node.xml.
+     * @param p_pool The pool that the node files are written on.
+     * @return true if the nodes were spawned anew; false if the node.xml was unchanged or unreadable.
+     * @note The file's never held whole; it's only parsed into a DOM if it can't be streamed.
+     */
+    static const bool spawnLocale(const QString&, QThreadPool*);
+
+    /**
+     * @brief Spawns the nodes of a node.xml that had to be parsed into a DOM.
      * @fn spawn
-     * @param
+     * @param p_dom The parsed node.xml of the locale.
+     * @param p_pool The pool that the node files are written on.
+     * @param p_mfstPth The path to the locale's manifest.
+     * @param p_mfst The manifest of the previous spawn, with the MD5 of the current node.xml.
      */
-    static void spawn(const QDomDocument&);
+    static void spawn(const QDomDocument&, QThreadPool*, const QString&, const Manifest&);
+
+    /**
+     * @brief Emits the snapshot of a locale and queues its changed nodes, in chunks, to be written.
+     * @fn spawn
+     * @param p_lcl The locale in question.
+     * @param p_syms The symbols read from its node.xml, in lower case and in order.
+     * @param p_flgs The flags of each symbol.
+     * @param p_pool The pool that the node files are written on.
+     * @param p_mfstPth The path to the locale's manifest.
+     * @param p_mfst The manifest of the previous spawn, with the MD5 of the current node.xml.
+     */
+    static void spawn(const QString&, const QStringList&, const QList<const FlagList*>&, QThreadPool*, const QString&, const Manifest&);
+
+    /**
+     * @brief Writes a single node file, streaming it straight to disk.
+     * @fn spawnNode
+     * @param p_dir The node directory of the node's locale.
+     * @param p_dt The node to be written.
+     */
+    static void spawnNode(const QString&, const Data&);
 
 public:
     /**
@@ -859,6 +1548,28 @@ public:
      */
     virtual const QString obtainFullSuffix (const QString &, const QString &) const;
 
+    /**
+     * @brief Lists the IDs of the spawned nodes of a locale.
+     * @fn nodes
+     * @param p_lcl The locale in question.
+     * @param p_ids The list to append the IDs to.
+     */
+    virtual const bool nodes(const QString&, NodeIdList&) const;
+
+    /**
+     * @brief Spawns the nodes of a single locale, unless its node.xml is unchanged.
+     * @fn prepare
+     * @param p_lcl The locale in question.
+     */
+    virtual const bool prepare(const QString&);
+
+    /**
+     * @brief Drops the cached template of a locale.
+     * @fn release
+     * @param p_lcl The locale in question.
+     */
+    virtual void release(const QString&);
+
     /**
      * @brief
      *
@@ -21,6 +21,8 @@
 
 #include <algorithm>
 #include <QDir>
+#include <QReadLocker>
+#include <QWriteLocker>
 #include "config.hpp"
 #include "models.hpp"
 #include "linguistics.hpp"
@@ -33,6 +35,20 @@ namespace Data {
 namespace Linguistics {
 QString System::s_dir = QString(WNTR_DATA_DIR) + "/" + QString(WNTRDATA_LING_DIR);
 QString System::s_lcl = QString(WNTR_LOCALE);
+QStringList System::s_prlds = QString(WNTRDATA_PRELOAD_LOCALES).split (",",QString::SkipEmptyParts);
+QReadWriteLock System::s_dirLck;
+QThreadStorage<QString*> System::s_thrdDirs;
+
+/// @note The SQLite storage holds pseudo nodes and suffixes itself, so it stands in for the DOM as well as the snapshots.
+static const QList<Lexical::Storage*> lexicalStorages() {
+    QList<Lexical::Storage*> l_strs;
+    if (QString(WNTRDATA_LEXICAL_STORAGE).compare ("Sqlite",Qt::CaseInsensitive) == 0)
+        l_strs << new Lexical::SqliteStorage;
+    else
+        l_strs << new Lexical::SnapshotStorage << new Lexical::DomStorage;
+
+    return l_strs;
+}
 
 void System::load ( const QString p_dir, const QString p_lcl ) {
     qDebug() << "(data) [System] # ling # System loading...";
@@ -40,10 +56,12 @@ void System::load ( const QString p_dir, const QString p_lcl ) {
     System::setDirectory ( p_dir );
     System::setLocale ( p_lcl );
 
-    Lexical::Cache::addStorage ((new Lexical::DomStorage));
+    foreach (Lexical::Storage* l_str, lexicalStorages ())
+        Lexical::Cache::addStorage (l_str);
+
     Rules::Cache::addStorage ((new Rules::DomStorage));
 
-    Lexical::Cache::generate();
+    Lexical::Cache::preload();
 
     qDebug() << "(data) [System] # ling # System loaded.";
 }
@@ -69,11 +87,51 @@ void System::setDirectory ( const QString p_dir ) {
 
     QDir* d = new QDir(p_dir);
     if (d->exists ()) {
+        QWriteLocker l_lck(&s_dirLck);
         System::s_dir = d->absolutePath();
         qDebug() << "(data) [System] # ling # Root dir:" << p_dir;
     }
 }
 
+const QString System::directory() {
+    if (s_thrdDirs.hasLocalData ())
+        return *s_thrdDirs.localData ();
+
+    QReadLocker l_lck(&s_dirLck);
+    return s_dir;
+}
+
+void System::setThreadDirectory(const QString& p_dir) {
+    s_thrdDirs.setLocalData (p_dir.isEmpty () ? NULL : new QString(QDir(p_dir).absolutePath ()));
+}
+
+/// @note Only the lexicon's rebuilt; the grammars are read through a cache that notices the files changing on its own.
+const bool System::reload(const QString& p_dir) {
+    const QString l_dir = p_dir.isEmpty () ? System::directory () : QDir(p_dir).absolutePath ();
+    if (!QDir(l_dir).exists ()) {
+        qWarning() << "(data) [System] # ling # Can't reload from" << l_dir << "; it doesn't exist.";
+        return false;
+    }
+
+    return Lexical::Cache::reload (l_dir,lexicalStorages ());
+}
+
+void System::setPreloads(const QStringList& p_lcls) {
+    System::s_prlds = p_lcls;
+    qDebug() << "(data) [System] # ling # Preloading:" << p_lcls;
+}
+
+const QStringList System::preloads() {
+    QStringList l_lcls;
+    l_lcls << System::locale ();
+    foreach (const QString l_lcl, s_prlds.contains ("*") ? System::locales () : s_prlds) {
+        if (!l_lcls.contains (l_lcl.trimmed ()))
+            l_lcls << l_lcl.trimmed ();
+    }
+
+    return l_lcls;
+}
+
 const QStringList System::locales() {
     QDir l_dir(System::directory ());
     const QString l_path = l_dir.absolutePath ();
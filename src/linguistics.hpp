@@ -25,7 +25,10 @@
 #define	LINGUISTICS_HPP
 
 #include <QString>
+#include <QStringList>
 #include <QObject>
+#include <QReadWriteLock>
+#include <QThreadStorage>
 
 namespace Wintermute {
 namespace Data {
@@ -41,6 +44,9 @@ class System {
 private:
     static QString s_dir; /**< Holds the location of the linguistic info. */
     static QString s_lcl; /**< Holds the current locale in use. */
+    static QStringList s_prlds; /**< Holds the locales loaded up front besides the current one. */
+    static QReadWriteLock s_dirLck; /**< Guards s_dir. */
+    static QThreadStorage<QString*> s_thrdDirs; /**< Holds the directory each thread building a lexicon looks at instead. */
 
 public:
     /**
@@ -73,19 +79,42 @@ public:
      */
     static const QStringList locales();
 
+    /**
+     * @brief Changes the locales loaded up front besides the current one.
+     * @fn setPreloads
+     * @param p_lcls The locales in question; "*" stands for every locale.
+     * @note Every other locale's loaded when it's first used.
+     */
+    static void setPreloads(const QStringList& );
+
+    /**
+     * @brief Obtains the locales loaded up front, the current one first.
+     * @fn preloads
+     * @note These are never unloaded for being idle.
+     */
+    static const QStringList preloads();
+
     /**
      * @brief Gets linguistics directory.
      * Returns the directory that's considered to be the absolute directory for loading linguistics information.
      * @fn getDirectory
      * @return string
+     * @note A thread building a lexicon over another directory sees that one instead; see setThreadDirectory().
      */
-    inline static const QString directory() {
-        return s_dir;
-    }
+    static const QString directory();
+
+    /**
+     * @brief Points directory() somewhere else for the calling thread alone.
+     * @fn setThreadDirectory
+     * @param p_dir The directory in question; an empty one lifts the override.
+     * @note This is how a new lexicon's built over a directory while every other thread's still served from the current one.
+     */
+    static void setThreadDirectory(const QString& );
 
     /**
      * @brief Loads the system with a specific storage directory and locale.
      * @fn load
+     * @note Only the locales listed by preloads() are loaded here.
      */
     static void load ( const QString = s_dir, const QString = s_lcl );
 
@@ -94,6 +123,15 @@ public:
      * @fn unload
      */
     static void unload();
+
+    /**
+     * @brief Builds a new lexicon in the background and swaps it in for the current one.
+     * @fn reload
+     * @param p_dir The directory to build it from; an empty one rebuilds the current directory.
+     * @return false if the new lexicon couldn't be built; the current one's kept then.
+     * @see Lexical::Cache::reload
+     */
+    static const bool reload(const QString& = QString());
 };
 } // namespaces
 }
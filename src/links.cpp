@@ -0,0 +1,121 @@
+/**
+ * @file links.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <algorithm>
+#include <QtAlgorithms>
+#include "links.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+
+LinkIndex::LinkIndex() : m_pstngs(), m_codes(), m_frzn(false), m_cnt(0) { }
+
+void LinkIndex::insert(const Atom p_code, const NodeId& p_id) {
+    QHash<Atom, QVector<NodeId> >::Iterator l_itr = m_pstngs.find(p_code);
+    if (l_itr == m_pstngs.end()) {
+        l_itr = m_pstngs.insert(p_code, QVector<NodeId>());
+        m_codes.insert(Atoms::resolve(p_code), p_code);
+    }
+
+    QVector<NodeId>& l_ids = l_itr.value();
+    if (!m_frzn) {
+        l_ids << p_id;
+        m_cnt++;
+        return;
+    }
+
+    QVector<NodeId>::Iterator l_pos = qLowerBound(l_ids.begin(), l_ids.end(), p_id);
+    if (l_pos != l_ids.end() && *l_pos == p_id)
+        return;
+
+    l_ids.insert(l_pos, p_id);
+    m_cnt++;
+}
+
+void LinkIndex::remove(const Atom p_code, const NodeId& p_id) {
+    QHash<Atom, QVector<NodeId> >::Iterator l_itr = m_pstngs.find(p_code);
+    if (l_itr == m_pstngs.end())
+        return;
+
+    QVector<NodeId>& l_ids = l_itr.value();
+    const int l_cnt = l_ids.count();
+    if (m_frzn) {
+        QVector<NodeId>::Iterator l_pos = qLowerBound(l_ids.begin(), l_ids.end(), p_id);
+        if (l_pos != l_ids.end() && *l_pos == p_id)
+            l_ids.erase(l_pos);
+    } else
+        l_ids.erase(std::remove(l_ids.begin(), l_ids.end(), p_id), l_ids.end());
+
+    m_cnt -= l_cnt - l_ids.count();
+    if (l_ids.isEmpty()) {
+        m_pstngs.erase(l_itr);
+        m_codes.remove(Atoms::resolve(p_code));
+    }
+}
+
+/// @note A node's filed once per distinct code by LocaleIndex, but a code written twice before freezing is collapsed here.
+void LinkIndex::freeze() {
+    if (m_frzn)
+        return;
+
+    m_cnt = 0;
+    for (QHash<Atom, QVector<NodeId> >::Iterator l_itr = m_pstngs.begin(); l_itr != m_pstngs.end(); ++l_itr) {
+        QVector<NodeId>& l_ids = l_itr.value();
+        qSort(l_ids);
+        l_ids.erase(std::unique(l_ids.begin(), l_ids.end()), l_ids.end());
+        l_ids.squeeze();
+        m_cnt += l_ids.count();
+    }
+
+    m_frzn = true;
+}
+
+const QVector<NodeId> LinkIndex::nodes(const QString& p_code) const {
+    const Atom l_code = m_codes.value(p_code, 0);
+    return l_code ? m_pstngs.value(l_code) : QVector<NodeId>();
+}
+
+const QStringList LinkIndex::codes(const QString& p_pfx) const {
+    QStringList l_codes;
+    QMap<QString, Atom>::ConstIterator l_itr = m_codes.lowerBound(p_pfx);
+    for (; l_itr != m_codes.constEnd() && l_itr.key().startsWith(p_pfx); ++l_itr)
+        l_codes << l_itr.key();
+
+    return l_codes;
+}
+
+const int LinkIndex::count(const QString& p_code) const {
+    const Atom l_code = m_codes.value(p_code, 0);
+    return l_code ? m_pstngs.value(l_code).count() : 0;
+}
+
+const int LinkIndex::entries() const {
+    return m_cnt;
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
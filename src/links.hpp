@@ -0,0 +1,124 @@
+/**
+ * @file links.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef LINKS_HPP
+#define LINKS_HPP
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "atom.hpp"
+#include "node.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct LinkIndex;
+
+/**
+ * @brief An inverted index from the link codes of a locale's flags to the nodes carrying them.
+ *
+ * The rules match nodes by the link codes of their flags (i.e.: <tt>Aen1~</tt>),
+ * which would otherwise mean reading every node to find those of a type.
+ * Each distinct code keeps the IDs of its nodes in a sorted vector; the
+ * codes themselves are kept sorted by text, so those sharing a prefix can
+ * be walked in order.
+ *
+ * While the index is being built, IDs are only appended; freeze() sorts
+ * them once, after which inserts and removals keep them sorted.
+ *
+ * @class LinkIndex links.hpp "src/links.hpp"
+ */
+class LinkIndex {
+private:
+    QHash<Atom, QVector<NodeId> > m_pstngs;
+    QMap<QString, Atom> m_codes;
+    bool m_frzn;
+    int m_cnt;
+
+public:
+    /**
+     * @brief Null constructor; an empty index.
+     * @fn LinkIndex
+     */
+    LinkIndex();
+
+    /**
+     * @brief Files a node under a link code.
+     * @fn insert
+     * @param p_code The interned link code.
+     * @param p_id The ID of the node.
+     */
+    void insert(const Atom, const NodeId& );
+
+    /**
+     * @brief Drops a node from under a link code.
+     * @fn remove
+     * @param p_code The interned link code.
+     * @param p_id The ID of the node.
+     */
+    void remove(const Atom, const NodeId& );
+
+    /**
+     * @brief Sorts what's been filed so far; called once the index has been built.
+     * @fn freeze
+     */
+    void freeze();
+
+    /**
+     * @brief Obtains the IDs of the nodes carrying a link code, in sorted order.
+     * @fn nodes
+     * @param p_code The link code in question.
+     */
+    const QVector<NodeId> nodes(const QString& ) const;
+
+    /**
+     * @brief Lists the link codes starting with a prefix, in sorted order.
+     * @fn codes
+     * @param p_pfx The prefix; an empty one lists every code.
+     */
+    const QStringList codes(const QString& = QString()) const;
+
+    /**
+     * @brief Obtains the number of nodes carrying a link code.
+     * @fn count
+     * @param p_code The link code in question.
+     */
+    const int count(const QString& ) const;
+
+    /**
+     * @brief Obtains the number of (code, node) pairs filed.
+     * @fn entries
+     */
+    const int entries() const;
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
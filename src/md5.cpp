@@ -329,12 +329,218 @@ std::string MD5::hexdigest() const {
 
 //////////////////////////////
 
+// copy the raw 16 bytes of the digest; zeroes if it hasn't been finalized
+void MD5::rawdigest ( unsigned char out[16] ) const {
+    if ( !finalized ) {
+        memset ( out, 0, 16 );
+        return;
+    }
+
+    memcpy ( out, digest, 16 );
+}
+
+//////////////////////////////
+
 std::ostream& operator<< ( std::ostream& out, MD5 md5 ) {
     return out << md5.hexdigest();
 }
 
 //////////////////////////////
 
+// Multi-buffer hashing. A single-block message (at most 55 bytes) is
+// padded into its own lane and the 64 steps run on every lane at once.
+// GCC's vector extensions give SSE2 code for the 4-lane path, and the
+// 8-lane path is compiled for AVX2 and only taken if the CPU has it.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define MD5_MULTIBUFFER 1
+#if defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+#define MD5_MULTIBUFFER_AVX2 1
+#endif
+#endif
+
+namespace {
+
+const unsigned int md5_blockmax = 55;
+
+#ifdef MD5_MULTIBUFFER
+const unsigned int md5_k[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+const int md5_s[16] = { S11, S12, S13, S14, S21, S22, S23, S24, S31, S32, S33, S34, S41, S42, S43, S44 };
+
+typedef unsigned int md5_v4 __attribute__ ( ( vector_size ( 16 ) ) );
+#ifdef MD5_MULTIBUFFER_AVX2
+typedef unsigned int md5_v8 __attribute__ ( ( vector_size ( 32 ) ) );
+#endif
+
+// pads one short message into lane `lane` of the transposed block `x`
+void md5_pack ( unsigned int* x, int lanes, int lane, const std::string& text ) {
+    unsigned char block[64];
+    const size_t len = text.length();
+    memset ( block, 0, sizeof block );
+    memcpy ( block, text.data(), len );
+    block[len] = 0x80;
+
+    const unsigned int bits = ( unsigned int ) len * 8;
+    block[56] = ( unsigned char ) bits;
+    block[57] = ( unsigned char ) ( bits >> 8 );
+
+    for ( int j = 0; j < 16; j++ )
+        x[j * lanes + lane] = ( ( unsigned int ) block[j*4] ) | ( ( ( unsigned int ) block[j*4+1] ) << 8 ) |
+                              ( ( ( unsigned int ) block[j*4+2] ) << 16 ) | ( ( ( unsigned int ) block[j*4+3] ) << 24 );
+}
+
+void md5_unpack ( const unsigned int* state, int lanes, int lane, unsigned char out[16] ) {
+    for ( int i = 0; i < 4; i++ ) {
+        const unsigned int v = state[i * lanes + lane];
+        out[i*4] = ( unsigned char ) v;
+        out[i*4+1] = ( unsigned char ) ( v >> 8 );
+        out[i*4+2] = ( unsigned char ) ( v >> 16 );
+        out[i*4+3] = ( unsigned char ) ( v >> 24 );
+    }
+}
+
+// the 64 steps of RFC 1321 over one block per lane; `x` is 16 vectors, `state` 4
+template <typename V>
+inline __attribute__ ( ( always_inline ) ) void md5_step ( V& a, V& b, V& c, V& d, const V& f, const V& x, const int i ) {
+    const int s = md5_s[ ( i / 16 ) * 4 + ( i % 4 )];
+    const V t = a + f + x + md5_k[i];
+    a = d;
+    d = c;
+    c = b;
+    b = b + ( ( t << s ) | ( t >> ( 32 - s ) ) );
+}
+
+template <typename V>
+inline __attribute__ ( ( always_inline ) ) void md5_transform_lanes ( const V* x, V* state ) {
+    V a = state[0], b = state[1], c = state[2], d = state[3];
+
+    for ( int i = 0; i < 16; i++ )
+        md5_step<V> ( a, b, c, d, ( b & c ) | ( ~b & d ), x[i], i );
+
+    for ( int i = 16; i < 32; i++ )
+        md5_step<V> ( a, b, c, d, ( b & d ) | ( c & ~d ), x[ ( 5 * i + 1 ) % 16], i );
+
+    for ( int i = 32; i < 48; i++ )
+        md5_step<V> ( a, b, c, d, b ^ c ^ d, x[ ( 3 * i + 5 ) % 16], i );
+
+    for ( int i = 48; i < 64; i++ )
+        md5_step<V> ( a, b, c, d, c ^ ( b | ~d ), x[ ( 7 * i ) % 16], i );
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+template <typename V, int N>
+inline __attribute__ ( ( always_inline ) ) void md5_digest_lanes ( const std::string* const texts[], unsigned char* const digests[] ) {
+    V x[16], state[4];
+    unsigned int* raw = ( unsigned int* ) x;
+
+    for ( int lane = 0; lane < N; lane++ )
+        md5_pack ( raw, N, lane, *texts[lane] );
+
+    const unsigned int init[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+    for ( int i = 0; i < 4; i++ )
+        for ( int lane = 0; lane < N; lane++ )
+            ( ( unsigned int* ) state ) [i * N + lane] = init[i];
+
+    md5_transform_lanes<V> ( x, state );
+
+    for ( int lane = 0; lane < N; lane++ )
+        md5_unpack ( ( const unsigned int* ) state, N, lane, digests[lane] );
+}
+
+void md5_digest4 ( const std::string* const texts[], unsigned char* const digests[] ) {
+    md5_digest_lanes<md5_v4, 4> ( texts, digests );
+}
+
+#ifdef MD5_MULTIBUFFER_AVX2
+__attribute__ ( ( target ( "avx2" ) ) )
+void md5_digest8 ( const std::string* const texts[], unsigned char* const digests[] ) {
+    md5_digest_lanes<md5_v8, 8> ( texts, digests );
+}
+#endif
+
+// hashes a group of up to `width` short messages, topping it up with copies of the first
+void md5_flush ( const std::string* group[], unsigned char* out[], int filled, int width ) {
+    unsigned char spare[8][16];
+    for ( int lane = filled; lane < width; lane++ ) {
+        group[lane] = group[0];
+        out[lane] = spare[lane];
+    }
+
+#ifdef MD5_MULTIBUFFER_AVX2
+    if ( width == 8 ) {
+        md5_digest8 ( group, out );
+        return;
+    }
+#endif
+    md5_digest4 ( group, out );
+}
+
+int md5_detect_lanes() {
+#ifdef MD5_MULTIBUFFER_AVX2
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports ( "avx2" ) )
+        return 8;
+#endif
+    return 4;
+}
+#endif
+
+}
+
+int MD5::lanes() {
+#ifdef MD5_MULTIBUFFER
+    static const int n = md5_detect_lanes();
+    return n;
+#else
+    return 1;
+#endif
+}
+
+void MD5::digestMany ( const std::string texts[], size_type n, unsigned char digests[][16] ) {
+    const int width = lanes();
+    const std::string* group[8];
+    unsigned char* out[8];
+    int filled = 0;
+
+    for ( size_type i = 0; i < n; i++ ) {
+        if ( width == 1 || texts[i].length() > md5_blockmax ) {
+            MD5 ( texts[i] ).rawdigest ( digests[i] );
+            continue;
+        }
+
+        group[filled] = &texts[i];
+        out[filled] = digests[i];
+
+        if ( ++filled == width ) {
+#ifdef MD5_MULTIBUFFER
+            md5_flush ( group, out, filled, width );
+#endif
+            filled = 0;
+        }
+    }
+
+#ifdef MD5_MULTIBUFFER
+    if ( filled > 0 )
+        md5_flush ( group, out, filled, width );
+#endif
+}
+
+//////////////////////////////
+
 std::string md5 ( const std::string str ) {
     MD5 md5 = MD5 ( str );
 
@@ -55,6 +55,14 @@ public:
     void update ( const char *buf, size_type length );
     MD5& finalize();
     std::string hexdigest() const;
+    void rawdigest ( unsigned char out[16] ) const;
+
+    // hash many independent messages at once; short ones (up to 55 bytes)
+    // go through SIMD lanes when the CPU has them, the rest one by one
+    static void digestMany ( const std::string texts[], size_type n, unsigned char digests[][16] );
+
+    // number of messages digestMany() hashes side by side on this CPU
+    static int lanes();
     friend std::ostream & operator<< ( std::ostream&, MD5 md5 );
 
 private:
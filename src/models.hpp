@@ -25,6 +25,8 @@
 #define MODELS_HPP
 
 #include "lexical.hpp"
+#include "snapshot.hpp"
+#include "sqlite.hpp"
 #include "rules.hpp"
 #include "linguistics.hpp"
 
@@ -0,0 +1,432 @@
+/**
+ * @file node.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <vector>
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <QMutexLocker>
+#include <QDebug>
+#include "md5.hpp"
+#include "node.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+
+static inline int hexValue(const ushort p_chr) {
+    if (p_chr >= '0' && p_chr <= '9') return p_chr - '0';
+    if (p_chr >= 'a' && p_chr <= 'f') return p_chr - 'a' + 10;
+    if (p_chr >= 'A' && p_chr <= 'F') return p_chr - 'A' + 10;
+    return -1;
+}
+
+/// @note IDs come in over D-Bus and JSON; a malformed one is reported and, given a symbol, derived from it instead.
+static const NodeId parseId(const QString& p_id, const QString& p_sym) {
+    bool l_ok = false;
+    const NodeId l_id = NodeId::fromHex(p_id, &l_ok);
+    if (l_ok || p_id.isEmpty())
+        return l_id;
+
+    if (p_sym.isEmpty()) {
+        qWarning() << "(data) [Node] Malformed ID" << p_id << "; the node has no ID.";
+        return l_id;
+    }
+
+    qWarning() << "(data) [Node] Malformed ID" << p_id << "; deriving it from" << p_sym << "instead.";
+    return NodeId::fromSymbol(p_sym);
+}
+
+NodeId::NodeId() : m_hi(0), m_lo(0) { }
+
+NodeId::NodeId(const quint64 p_hi, const quint64 p_lo) : m_hi(p_hi), m_lo(p_lo) { }
+
+bool NodeId::operator==(const NodeId& p_id) const {
+    return m_hi == p_id.m_hi && m_lo == p_id.m_lo;
+}
+
+bool NodeId::operator!=(const NodeId& p_id) const {
+    return !(*this == p_id);
+}
+
+bool NodeId::operator<(const NodeId& p_id) const {
+    return m_hi < p_id.m_hi || (m_hi == p_id.m_hi && m_lo < p_id.m_lo);
+}
+
+const bool NodeId::isNull() const {
+    return m_hi == 0 && m_lo == 0;
+}
+
+const QString NodeId::toHex() const {
+    static const char l_hex[] = "0123456789abcdef";
+    uchar l_raw[16];
+    toBytes(l_raw);
+
+    QString l_id(32, QChar('0'));
+    QChar* l_chrs = l_id.data();
+    for (int i = 0; i < 16; i++) {
+        l_chrs[i * 2] = QChar(l_hex[l_raw[i] >> 4]);
+        l_chrs[i * 2 + 1] = QChar(l_hex[l_raw[i] & 0x0f]);
+    }
+
+    return l_id;
+}
+
+void NodeId::toBytes(uchar* p_raw) const {
+    qToBigEndian<quint64>(m_hi, p_raw);
+    qToBigEndian<quint64>(m_lo, p_raw + 8);
+}
+
+const NodeId NodeId::fromBytes(const uchar* p_raw) {
+    return NodeId(qFromBigEndian<quint64>(p_raw), qFromBigEndian<quint64>(p_raw + 8));
+}
+
+const NodeId NodeId::fromHex(const QString& p_hex, bool* p_ok) {
+    if (p_ok)
+        *p_ok = false;
+
+    if (p_hex.length() != 32)
+        return NodeId();
+
+    uchar l_raw[16];
+    const QChar* l_chrs = p_hex.constData();
+    for (int i = 0; i < 16; i++) {
+        const int l_hi = hexValue(l_chrs[i * 2].unicode());
+        const int l_lo = hexValue(l_chrs[i * 2 + 1].unicode());
+        if (l_hi < 0 || l_lo < 0)
+            return NodeId();
+
+        l_raw[i] = (uchar) ((l_hi << 4) | l_lo);
+    }
+
+    if (p_ok)
+        *p_ok = true;
+
+    return fromBytes(l_raw);
+}
+
+/// @todo Use MD-5 hashing from another library (QCA has it) so we can eliminate md5.*pp.
+/// @note Lower-cases up to p_len ASCII characters into p_out; false at the first character that isn't ASCII.
+static inline bool foldAscii(const QChar* p_chrs, const int p_len, char* p_out) {
+    for (int i = 0; i < p_len; i++) {
+        const ushort l_chr = p_chrs[i].unicode();
+        if (l_chr >= 0x80)
+            return false;
+
+        p_out[i] = (char) ((l_chr >= 'A' && l_chr <= 'Z') ? (l_chr + ('a' - 'A')) : l_chr);
+    }
+
+    return true;
+}
+
+const NodeId NodeId::fromSymbol(const QString& p_sym) {
+    uchar l_raw[16];
+    char l_buf[64];
+    const QChar* l_chrs = p_sym.constData();
+    const int l_len = p_sym.length();
+    MD5 l_md5;
+
+    // ASCII symbols fold exactly as toLower() would and stay ASCII through toStdString(), so they're hashed straight
+    // off of the UTF-16 buffer. Anything else takes the full Unicode path.
+    int l_pos = 0;
+    for (; l_pos < l_len; l_pos += (int) sizeof(l_buf)) {
+        const int l_chnk = qMin(l_len - l_pos, (int) sizeof(l_buf));
+        if (!foldAscii(l_chrs + l_pos, l_chnk, l_buf))
+            break;
+
+        l_md5.update(l_buf, (MD5::size_type) l_chnk);
+    }
+
+    if (l_pos < l_len)
+        MD5(p_sym.toLower().toStdString()).rawdigest(l_raw);
+    else
+        l_md5.finalize().rawdigest(l_raw);
+
+    return fromBytes(l_raw);
+}
+
+void NodeId::fromSymbols(const QStringList& p_syms, NodeIdList& p_ids) {
+    if (p_syms.isEmpty())
+        return;
+
+    std::vector<std::string> l_txts;
+    l_txts.reserve(p_syms.count());
+    foreach (const QString& l_sym, p_syms) {
+        std::string l_txt(l_sym.length(), '\0');
+        if (!l_sym.isEmpty() && !foldAscii(l_sym.constData(), l_sym.length(), &l_txt[0]))
+            l_txt = l_sym.toLower().toStdString();
+
+        l_txts.push_back(l_txt);
+    }
+
+    std::vector<uchar> l_raw(l_txts.size() * 16);
+    MD5::digestMany(&l_txts[0], (MD5::size_type) l_txts.size(), (uchar (*)[16]) &l_raw[0]);
+
+    p_ids.reserve(p_ids.count() + p_syms.count());
+    for (size_t i = 0; i < l_txts.size(); i++)
+        p_ids << fromBytes(&l_raw[i * 16]);
+}
+
+Flag::Flag() : m_guid(0), m_link(0) { }
+
+Flag::Flag(const QString& p_guid, const QString& p_link) : m_guid(Atoms::intern(p_guid)), m_link(Atoms::intern(p_link)) { }
+
+Flag::Flag(const Atom p_guid, const Atom p_link) : m_guid(p_guid), m_link(p_link) { }
+
+const QString Flag::guid() const {
+    return Atoms::resolve(m_guid);
+}
+
+const QString Flag::link() const {
+    return Atoms::resolve(m_link);
+}
+
+bool Flag::operator==(const Flag& p_flg) const {
+    return m_guid == p_flg.m_guid && m_link == p_flg.m_link;
+}
+
+bool Flag::operator!=(const Flag& p_flg) const {
+    return !(*this == p_flg);
+}
+
+bool Flag::operator<(const Flag& p_flg) const {
+    return m_guid != p_flg.m_guid && guid() < p_flg.guid();
+}
+
+QHash<QByteArray, const FlagList*> FlagSets::s_sets;
+QMutex FlagSets::s_mtx;
+
+/// @note The key is the set's handles in order; handles are unique per string, so equal keys mean equal sets.
+const FlagList* FlagSets::intern(const FlagList& p_flgs) {
+    if (p_flgs.isEmpty())
+        return empty();
+
+    QByteArray l_key;
+    l_key.resize(p_flgs.count() * 8);
+    uchar* l_raw = (uchar*) l_key.data();
+    for (int i = 0; i < p_flgs.count(); i++) {
+        qToLittleEndian<quint32>(p_flgs.at(i).m_guid, l_raw + (i * 8));
+        qToLittleEndian<quint32>(p_flgs.at(i).m_link, l_raw + (i * 8) + 4);
+    }
+
+    QMutexLocker l_lck(&s_mtx);
+    const FlagList*& l_set = s_sets[l_key];
+    if (!l_set)
+        l_set = new FlagList(p_flgs);
+
+    return l_set;
+}
+
+const FlagList* FlagSets::empty() {
+    static const FlagList s_empty;
+    return &s_empty;
+}
+
+const int FlagSets::count() {
+    QMutexLocker l_lck(&s_mtx);
+    return s_sets.count();
+}
+
+NodeData::NodeData() : QSharedData(), m_id(), m_lcl(0), m_sym(), m_flgs(FlagSets::empty()) { }
+
+NodeData::NodeData(const NodeData& p_dt) : QSharedData(p_dt), m_id(p_dt.m_id),
+        m_lcl(p_dt.m_lcl), m_sym(p_dt.m_sym), m_flgs(p_dt.m_flgs) { }
+
+Node::Node() : m_d(new NodeData) { }
+
+Node::Node(const QString& p_id, const QString& p_lcl, const QString& p_sym, const QVariantMap& p_flgs) : m_d(new NodeData) {
+    m_d->m_id = parseId(p_id, p_sym);
+    m_d->m_lcl = Atoms::intern(p_lcl);
+    m_d->m_sym = p_sym;
+    m_d->m_flgs = FlagSets::intern(toFlagList(p_flgs));
+}
+
+Node::Node(const QString& p_id, const QString& p_lcl, const QString& p_sym, const FlagList& p_flgs) : m_d(new NodeData) {
+    m_d->m_id = parseId(p_id, p_sym);
+    m_d->m_lcl = Atoms::intern(p_lcl);
+    m_d->m_sym = p_sym;
+    setFlagList(p_flgs);
+}
+
+Node::Node(const QString& p_id, const QString& p_lcl, const QString& p_sym, const FlagList* p_flgs) : m_d(new NodeData) {
+    m_d->m_id = parseId(p_id, p_sym);
+    m_d->m_lcl = Atoms::intern(p_lcl);
+    m_d->m_sym = p_sym;
+    setFlagSet(p_flgs);
+}
+
+Node::Node(const NodeId& p_id, const Atom p_lcl, const QString& p_sym, const FlagList* p_flgs) : m_d(new NodeData) {
+    m_d->m_id = p_id;
+    m_d->m_lcl = p_lcl;
+    m_d->m_sym = p_sym;
+    setFlagSet(p_flgs);
+}
+
+Node::Node(const Node& p_nd) : m_d(p_nd.m_d) { }
+
+Node::~Node() { }
+
+Node& Node::operator=(const Node& p_nd) {
+    m_d = p_nd.m_d;
+    return *this;
+}
+
+bool Node::operator==(const Node& p_nd) const {
+    if (m_d == p_nd.m_d)
+        return true;
+
+    // Interned sets are equal only if they're the same set.
+    return m_d->m_id == p_nd.m_d->m_id && m_d->m_lcl == p_nd.m_d->m_lcl && m_d->m_sym == p_nd.m_d->m_sym &&
+           m_d->m_flgs == p_nd.m_d->m_flgs;
+}
+
+bool Node::operator!=(const Node& p_nd) const {
+    return !(*this == p_nd);
+}
+
+const QString Node::id() const {
+    return m_d->m_id.isNull() ? QString() : m_d->m_id.toHex();
+}
+
+const NodeId Node::nodeId() const {
+    return m_d->m_id;
+}
+
+const QString Node::locale() const {
+    return Atoms::resolve(m_d->m_lcl);
+}
+
+const Atom Node::localeAtom() const {
+    return m_d->m_lcl;
+}
+
+const QString Node::symbol() const {
+    return m_d->m_sym;
+}
+
+const QVariantMap Node::flags() const {
+    QVariantMap l_flgs;
+    for (int i = 0; i < m_d->m_flgs->count(); i++)
+        l_flgs.insert(m_d->m_flgs->at(i).guid(), m_d->m_flgs->at(i).link());
+
+    return l_flgs;
+}
+
+const FlagList& Node::flagList() const {
+    return *m_d->m_flgs;
+}
+
+const int Node::flagCount() const {
+    return m_d->m_flgs->count();
+}
+
+/// @note A GUID that was never interned can't be on any node; the flags are few enough to scan.
+const QString Node::link(const QString& p_guid) const {
+    Atom l_guid = 0;
+    if (!Atoms::find(p_guid, l_guid))
+        return QString();
+
+    for (int i = 0; i < m_d->m_flgs->count(); i++) {
+        if (m_d->m_flgs->at(i).m_guid == l_guid)
+            return m_d->m_flgs->at(i).link();
+    }
+
+    return QString();
+}
+
+void Node::setID(const QString& p_id) {
+    m_d->m_id = parseId(p_id, m_d->m_sym);
+}
+
+void Node::setNodeId(const NodeId& p_id) {
+    m_d->m_id = p_id;
+}
+
+void Node::setLocale(const QString& p_lcl) {
+    m_d->m_lcl = Atoms::intern(p_lcl);
+}
+
+void Node::setSymbol(const QString& p_sym) {
+    m_d->m_sym = p_sym;
+    m_d->m_id = NodeId::fromSymbol(p_sym);
+}
+
+void Node::setFlags(const QVariantMap& p_flgs) {
+    m_d->m_flgs = FlagSets::intern(toFlagList(p_flgs));
+}
+
+/// @note Lists coming off of snapshots and other nodes are already sorted, so they're only copied when they're not.
+void Node::setFlagList(const FlagList& p_flgs) {
+    bool l_srtd = true;
+    for (int i = 1; l_srtd && i < p_flgs.count(); i++)
+        l_srtd = !(p_flgs.at(i) < p_flgs.at(i - 1));
+
+    if (l_srtd) {
+        m_d->m_flgs = FlagSets::intern(p_flgs);
+        return;
+    }
+
+    FlagList l_flgs(p_flgs);
+    qStableSort(l_flgs.data(), l_flgs.data() + l_flgs.count());
+    m_d->m_flgs = FlagSets::intern(l_flgs);
+}
+
+void Node::setFlagSet(const FlagList* p_flgs) {
+    m_d->m_flgs = p_flgs ? p_flgs : FlagSets::empty();
+}
+
+const bool Node::isNull() const {
+    return m_d->m_id.isNull() && m_d->m_lcl == 0 && m_d->m_sym.isEmpty() && m_d->m_flgs->isEmpty();
+}
+
+const QString Node::idFromString(const QString& p_sym) {
+    return NodeId::fromSymbol(p_sym).toHex();
+}
+
+const QStringList Node::idsFromStrings(const QStringList& p_syms) {
+    NodeIdList l_ids;
+    NodeId::fromSymbols(p_syms, l_ids);
+
+    QStringList l_hex;
+    foreach (const NodeId& l_id, l_ids)
+        l_hex << l_id.toHex();
+
+    return l_hex;
+}
+
+/// @note QVariantMap iterates in key order, so the list comes out sorted.
+const FlagList Node::toFlagList(const QVariantMap& p_flgs) {
+    FlagList l_flgs;
+    l_flgs.reserve(p_flgs.count());
+
+    QVariantMap::ConstIterator l_itr = p_flgs.constBegin(), l_end = p_flgs.constEnd();
+    for (; l_itr != l_end; ++l_itr)
+        l_flgs.append(Flag(l_itr.key(), l_itr.value().toString()));
+
+    return l_flgs;
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,417 @@
+/**
+ * @file node.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef NODE_HPP
+#define NODE_HPP
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVariantMap>
+#include <QVarLengthArray>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QMutex>
+#include "atom.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct NodeId;
+typedef QList<NodeId> NodeIdList;
+struct Flag;
+struct FlagSets;
+struct Node;
+
+/**
+ * @brief The 128-bit ID of a node; the MD-5 digest of its lowercased symbol.
+ *
+ * IDs are kept and compared as two integers. The hexadecimal form is
+ * only produced where a node meets the outside world: its file name,
+ * D-Bus and the paging cursors handed out over it. The halves are in
+ * the digest's byte order (big-endian), so IDs sort like their hex.
+ *
+ * @class NodeId node.hpp "src/node.hpp"
+ */
+class NodeId {
+public:
+    quint64 m_hi;
+    quint64 m_lo;
+
+    /**
+     * @brief Null constructor; the all-zero ID.
+     * @fn NodeId
+     */
+    NodeId();
+
+    /**
+     * @brief Constructor.
+     * @fn NodeId
+     * @param p_hi The upper eight bytes of the digest.
+     * @param p_lo The lower eight bytes of the digest.
+     */
+    NodeId(const quint64, const quint64 );
+
+    bool operator==(const NodeId& ) const;
+    bool operator!=(const NodeId& ) const;
+    bool operator<(const NodeId& ) const;
+
+    /**
+     * @brief Determines if this is the all-zero ID.
+     * @fn isNull
+     */
+    const bool isNull() const;
+
+    /**
+     * @brief Obtains the lower-case hexadecimal form of the ID.
+     * @fn toHex
+     */
+    const QString toHex() const;
+
+    /**
+     * @brief Writes the 16 raw bytes of the ID.
+     * @fn toBytes
+     * @param p_raw The buffer to hold the bytes.
+     */
+    void toBytes(uchar* ) const;
+
+    /**
+     * @brief Reads an ID from its 16 raw bytes.
+     * @fn fromBytes
+     * @param p_raw The bytes in question.
+     */
+    static const NodeId fromBytes(const uchar* );
+
+    /**
+     * @brief Parses the hexadecimal form of an ID, in either case.
+     * @fn fromHex
+     * @param p_hex The hexadecimal ID.
+     * @param p_ok Set to whether the ID was well-formed.
+     * @return The ID, or the null ID if it's malformed.
+     */
+    static const NodeId fromHex(const QString&, bool* = 0 );
+
+    /**
+     * @brief Obtains the ID of a symbol.
+     * @fn fromSymbol
+     * @param p_sym The symbol in question.
+     */
+    static const NodeId fromSymbol(const QString& );
+
+    /**
+     * @brief Obtains the IDs of many symbols at once.
+     * @fn fromSymbols
+     * @param p_syms The symbols in question.
+     * @param p_ids The list to append their IDs to, in the same order.
+     * @note Short symbols are hashed side by side (see MD5::digestMany()),
+     *       so this beats calling fromSymbol() in a loop.
+     */
+    static void fromSymbols(const QStringList&, NodeIdList& );
+};
+
+/// @note The digest is uniformly distributed already; folding its lower half is enough.
+inline uint qHash(const NodeId& p_id) {
+    return (uint) (p_id.m_lo ^ (p_id.m_lo >> 32));
+}
+struct NodeData;
+
+/**
+ * @brief A single flag of a node; its GUID and the link code it carries.
+ *
+ * Both are interned, so a flag is the size of two integers.
+ *
+ * @class Flag node.hpp "src/node.hpp"
+ */
+class Flag {
+public:
+    Atom m_guid;
+    Atom m_link;
+
+    /**
+     * @brief Null constructor.
+     * @fn Flag
+     */
+    Flag();
+
+    /**
+     * @brief Constructor.
+     * @fn Flag
+     * @param p_guid The GUID of the flag.
+     * @param p_link The link code of the flag.
+     */
+    Flag(const QString&, const QString& );
+
+    /**
+     * @brief Constructor.
+     * @fn Flag
+     * @param p_guid The interned GUID of the flag.
+     * @param p_link The interned link code of the flag.
+     */
+    Flag(const Atom, const Atom );
+
+    const QString guid() const;
+    const QString link() const;
+
+    bool operator==(const Flag& ) const;
+    bool operator!=(const Flag& ) const;
+
+    /**
+     * @brief Orders flags by the text of their GUID.
+     * @fn operator<
+     * @note The handles aren't stable across processes, so they can't be
+     *       what orders flags that end up hashed or written to disk.
+     */
+    bool operator<(const Flag& ) const;
+};
+
+/**
+ * @brief The flags of a node, sorted by GUID.
+ *
+ * Nodes rarely carry more than a handful of flags, so they're kept inline
+ * rather than in a map of variants.
+ */
+typedef QVarLengthArray<Flag, 4> FlagList;
+
+/**
+ * @brief The process-wide table of distinct flag sets.
+ *
+ * Plenty of nodes (and the same nodes across locales) carry the very same
+ * flags, so each distinct FlagList is kept once, addressed by its content,
+ * and nodes point at it. Like Atoms, sets are never dropped.
+ *
+ * @class FlagSets node.hpp "src/node.hpp"
+ */
+class FlagSets {
+private:
+    static QHash<QByteArray, const FlagList*> s_sets;
+    static QMutex s_mtx;
+
+public:
+    /**
+     * @brief Interns a flag set.
+     * @fn intern
+     * @param p_flgs The flags in question, sorted by GUID.
+     * @return The shared copy of the set; it lives as long as the process.
+     */
+    static const FlagList* intern(const FlagList& );
+
+    /**
+     * @brief Obtains the shared empty flag set.
+     * @fn empty
+     */
+    static const FlagList* empty();
+
+    /**
+     * @brief Obtains the number of distinct flag sets interned.
+     * @fn count
+     */
+    static const int count();
+};
+
+/**
+ * @brief The shared payload of a Node.
+ * @class NodeData node.hpp "src/node.hpp"
+ */
+class NodeData : public QSharedData {
+public:
+    NodeId m_id;
+    Atom m_lcl;
+    QString m_sym;
+    const FlagList* m_flgs;
+
+    NodeData();
+    NodeData(const NodeData& );
+};
+
+/**
+ * @brief An implicitly shared, value-typed lexical node.
+ *
+ * Node carries what Data does (the ID, locale, symbol and flags of a
+ * node) without Data's QObject, so copying one is a reference count
+ * bump. It's what the Cache and the storages keep internally; Data
+ * remains the reflective wrapper used for serialization.
+ *
+ * @class Node node.hpp "src/node.hpp"
+ */
+class Node {
+private:
+    QSharedDataPointer<NodeData> m_d;
+
+public:
+    /**
+     * @brief Null constructor.
+     * @fn Node
+     */
+    Node();
+
+    /**
+     * @brief Constructor.
+     * @fn Node
+     * @param p_id The ID of the node.
+     * @param p_lcl The locale of the node.
+     * @param p_sym The symbol of the node.
+     * @param p_flgs The flags of the node.
+     */
+    explicit Node(const QString&, const QString&, const QString& = QString(), const QVariantMap& = QVariantMap());
+
+    /**
+     * @brief Constructor.
+     * @fn Node
+     * @param p_id The ID of the node.
+     * @param p_lcl The locale of the node.
+     * @param p_sym The symbol of the node.
+     * @param p_flgs The flags of the node, in any order.
+     */
+    Node(const QString&, const QString&, const QString&, const FlagList& );
+
+    /**
+     * @brief Constructor.
+     * @fn Node
+     * @param p_id The ID of the node.
+     * @param p_lcl The locale of the node.
+     * @param p_sym The symbol of the node.
+     * @param p_flgs The flags of the node, as interned by FlagSets.
+     */
+    Node(const QString&, const QString&, const QString&, const FlagList* );
+
+    /**
+     * @brief Constructor.
+     * @fn Node
+     * @param p_id The ID of the node.
+     * @param p_lcl The locale of the node.
+     * @param p_sym The symbol of the node.
+     * @param p_flgs The flags of the node, as interned by FlagSets.
+     */
+    Node(const NodeId&, const Atom, const QString&, const FlagList* );
+
+    Node(const Node& );
+    ~Node();
+    Node& operator=(const Node& );
+    bool operator==(const Node& ) const;
+    bool operator!=(const Node& ) const;
+
+    /**
+     * @brief Obtains the hexadecimal form of the node's ID.
+     * @fn id
+     * @see nodeId
+     */
+    const QString id() const;
+    const NodeId nodeId() const;
+    const QString locale() const;
+    const QString symbol() const;
+
+    /**
+     * @brief Obtains the interned locale of the node.
+     * @fn localeAtom
+     */
+    const Atom localeAtom() const;
+
+    /**
+     * @brief Obtains the flags of the node as a map of GUIDs to link codes.
+     * @fn flags
+     */
+    const QVariantMap flags() const;
+
+    /**
+     * @brief Obtains the flags of the node, sorted by GUID.
+     * @fn flagList
+     */
+    const FlagList& flagList() const;
+
+    /**
+     * @brief Obtains the number of flags of the node.
+     * @fn flagCount
+     */
+    const int flagCount() const;
+
+    /**
+     * @brief Obtains the link code of a flag.
+     * @fn link
+     * @param p_guid The GUID of the flag.
+     * @return The link code, or a null string if the node hasn't got the flag.
+     */
+    const QString link(const QString& ) const;
+
+    void setID(const QString& );
+    void setNodeId(const NodeId& );
+    void setLocale(const QString& );
+
+    /**
+     * @brief Changes the symbol of the node, along with its ID.
+     * @fn setSymbol
+     * @param p_sym The symbol for the node to hold now.
+     */
+    void setSymbol(const QString& );
+
+    void setFlags(const QVariantMap& );
+    void setFlagList(const FlagList& );
+
+    /**
+     * @brief Points the node at a set of flags interned by FlagSets.
+     * @fn setFlagSet
+     * @param p_flgs The flag set in question.
+     */
+    void setFlagSet(const FlagList* );
+
+    /**
+     * @brief Determines if every field of the node is empty.
+     * @fn isNull
+     */
+    const bool isNull() const;
+
+    /**
+     * @brief Obtains the hexadecimal ID from a said QString.
+     * @fn idFromString
+     * @param p_sym The text to be transformed into its proper ID.
+     * @see NodeId::fromSymbol
+     */
+    static const QString idFromString(const QString& );
+
+    /**
+     * @brief Obtains the hexadecimal IDs of many QStrings at once.
+     * @fn idsFromStrings
+     * @param p_syms The texts to be transformed into their proper IDs.
+     * @see NodeId::fromSymbols
+     */
+    static const QStringList idsFromStrings(const QStringList& );
+
+    /**
+     * @brief Converts a map of GUIDs to link codes into a sorted FlagList.
+     * @fn toFlagList
+     * @param p_flgs The map in question.
+     */
+    static const FlagList toFlagList(const QVariantMap& );
+};
+
+}
+}
+}
+}
+
+Q_DECLARE_TYPEINFO(Wintermute::Data::Linguistics::Lexical::NodeId, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(Wintermute::Data::Linguistics::Lexical::Flag, Q_MOVABLE_TYPE);
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,127 @@
+/**
+ * @file nodexml.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <QIODevice>
+#include "nodexml.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+
+NodeXmlReader::NodeXmlReader(QIODevice* p_dev) : m_xml(p_dev), m_lcl(), m_hasRoot(false), m_hasPsd(false), m_psdFlg(), m_sfx(),
+    m_inMap(false), m_mapDone(false) { }
+
+/// @note Like DomLoadModel::loadTo(), every child element's read as a flag, whatever its name.
+const QVariantMap NodeXmlReader::readFlags() {
+    QVariantMap l_mp;
+    while (m_xml.readNextStartElement ()) {
+        const QXmlStreamAttributes l_attrs = m_xml.attributes ();
+        l_mp.insert (l_attrs.value ("guid").toString (),l_attrs.value ("link").toString ());
+        m_xml.skipCurrentElement ();
+    }
+
+    return l_mp;
+}
+
+/// @return true if the element just started is a <Data> element, left for the caller to read.
+const bool NodeXmlReader::visit() {
+    const QStringRef l_nm = m_xml.name ();
+    if (!m_hasRoot) {
+        m_hasRoot = true;
+        m_lcl = m_xml.attributes ().value ("locale").toString ();
+    } else if (l_nm == QLatin1String("Data"))
+        return true;
+    else if (l_nm == QLatin1String("Pseudo") && !m_hasPsd) {
+        m_hasPsd = true;
+        m_psdFlg = readFlags();
+    } else if (l_nm == QLatin1String("Mapping") && !m_mapDone)
+        m_inMap = true;
+    else if (l_nm == QLatin1String("Suffix") && m_inMap) {
+        // Only the first mapping counts, and the first of a suffix's mappings wins.
+        const QXmlStreamAttributes l_attrs = m_xml.attributes ();
+        const QString l_from = l_attrs.value ("from").toString ();
+        if (!m_sfx.contains (l_from))
+            m_sfx.insert (l_from,l_attrs.value ("to").toString ());
+    }
+
+    return false;
+}
+
+const bool NodeXmlReader::advance() {
+    while (!m_xml.atEnd ()) {
+        const QXmlStreamReader::TokenType l_tkn = m_xml.readNext ();
+        if (l_tkn == QXmlStreamReader::StartElement) {
+            if (visit())
+                return true;
+        } else if (l_tkn == QXmlStreamReader::EndElement && m_inMap && m_xml.name () == QLatin1String("Mapping")) {
+            m_inMap = false;
+            m_mapDone = true;
+        }
+    }
+
+    return false;
+}
+
+const bool NodeXmlReader::next(QString& p_sym, QVariantMap& p_flgs) {
+    if (!advance())
+        return false;
+
+    p_sym = m_xml.attributes ().value ("symbol").toString ().toLower ();
+    p_flgs = readFlags();
+    return true;
+}
+
+void NodeXmlReader::readTemplate() {
+    while (!(m_hasPsd && m_mapDone) && advance())
+        m_xml.skipCurrentElement ();
+}
+
+const bool NodeXmlReader::hasError() const {
+    return m_xml.hasError ();
+}
+
+const QString NodeXmlReader::errorString() const {
+    return QString("%1 (line %2, column %3)").arg (m_xml.errorString ()).arg (m_xml.lineNumber ()).arg (m_xml.columnNumber ());
+}
+
+const QString NodeXmlReader::locale() const {
+    return m_lcl;
+}
+
+const bool NodeXmlReader::hasPseudo() const {
+    return m_hasPsd;
+}
+
+const QVariantMap NodeXmlReader::pseudoFlags() const {
+    return m_psdFlg;
+}
+
+const QHash<QString, QString> NodeXmlReader::suffixes() const {
+    return m_sfx;
+}
+
+}
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
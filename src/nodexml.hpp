@@ -0,0 +1,116 @@
+/**
+ * @file nodexml.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef NODEXML_HPP
+#define NODEXML_HPP
+
+#include <QHash>
+#include <QString>
+#include <QVariantMap>
+#include <QXmlStreamReader>
+
+class QIODevice;
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct NodeXmlReader;
+
+/**
+ * @brief Pulls the parts of a locale's node.xml out of a stream, an element at a time.
+ *
+ * Only the element being read is ever held, so a node.xml of any size
+ * is read in bounded memory; it's what DomStorage and SqliteStorage read
+ * node.xml with. DomStorage falls back on the DOM if the stream's malformed.
+ *
+ * @class NodeXmlReader nodexml.hpp "src/nodexml.hpp"
+ */
+class NodeXmlReader {
+private:
+    QXmlStreamReader m_xml;
+    QString m_lcl;
+    bool m_hasRoot;
+    bool m_hasPsd;
+    QVariantMap m_psdFlg;
+    QHash<QString, QString> m_sfx;
+    bool m_inMap;
+    bool m_mapDone;
+
+    const QVariantMap readFlags();
+    const bool visit();
+    const bool advance();
+
+public:
+    /**
+     * @brief Constructor.
+     * @fn NodeXmlReader
+     * @param p_dev The device holding the node.xml; it must be open for reading.
+     */
+    explicit NodeXmlReader(QIODevice* );
+
+    /**
+     * @brief Reads the next node.
+     * @fn next
+     * @param p_sym Set to the node's symbol, in lower case.
+     * @param p_flgs Set to the node's flags.
+     * @return false once the stream's run out (or gone bad; see hasError()).
+     */
+    const bool next(QString&, QVariantMap& );
+
+    /**
+     * @brief Reads just far enough to have the pseudo node and the suffix mappings, skipping every node.
+     * @fn readTemplate
+     */
+    void readTemplate();
+
+    const bool hasError() const;
+
+    /**
+     * @brief Describes what went wrong with the stream, and where.
+     * @fn errorString
+     */
+    const QString errorString() const;
+
+    /**
+     * @brief Obtains the locale named by the root element.
+     * @fn locale
+     */
+    const QString locale() const;
+
+    const bool hasPseudo() const;
+    const QVariantMap pseudoFlags() const;
+
+    /**
+     * @brief Obtains the suffix mappings read so far, keyed by the 'from' suffix.
+     * @fn suffixes
+     */
+    const QHash<QString, QString> suffixes() const;
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
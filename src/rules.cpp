@@ -25,6 +25,9 @@
 #include "config.hpp"
 #include <QFile>
 #include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QXmlStreamReader>
 #include <algorithm>
 #include <qjson/parser.h>
 #include <qjson/serializer.h>
@@ -37,6 +40,8 @@ namespace Data {
 namespace Linguistics {
 namespace Rules {
 Cache::StorageList Cache::s_stores;
+QHash<QString, DomStorage::GrammarEntry> DomStorage::s_gmrs;
+QMutex DomStorage::s_gmrMtx;
 
 Bond::Bond() { }
 
@@ -339,6 +344,122 @@ void DomSaveModel::setType(const QString& p_bndTyp) {}
 
 DomSaveModel::~DomSaveModel () { }
 
+Grammar::Grammar() : m_rls(), m_bnds() { }
+
+/// @note Only Rule and Bind elements are kept; everything else (i.e.: Import) is passed over, as the DOM path does.
+const bool Grammar::load(const QString& p_pth, Grammar& p_gmr, QString* p_err) {
+    QFile l_file(p_pth);
+    if (!l_file.open (QIODevice::ReadOnly)) {
+        if (p_err)
+            *p_err = l_file.errorString ();
+        return false;
+    }
+
+    Grammar l_gmr;
+    QXmlStreamReader l_xml(&l_file);
+    QVector<int> l_rlStck;
+    QVector<bool> l_isRl;
+
+    while (!l_xml.atEnd ()) {
+        const QXmlStreamReader::TokenType l_tkn = l_xml.readNext ();
+
+        if (l_tkn == QXmlStreamReader::StartElement) {
+            const QXmlStreamAttributes l_attrs = l_xml.attributes ();
+            const bool l_rl = (l_xml.name () == QLatin1String("Rule"));
+            l_isRl << l_rl;
+
+            if (l_rl) {
+                Rule l_rule;
+                l_rule.m_hasTyp = l_attrs.hasAttribute ("type");
+                l_rule.m_typ = l_attrs.value ("type").toString ();
+                l_rule.m_prnt = l_rlStck.isEmpty () ? -1 : l_rlStck.last ();
+                l_rule.m_fullTyp = (l_rule.m_prnt == -1 ? QString() : l_gmr.m_rls.at (l_rule.m_prnt).m_fullTyp) + l_rule.m_typ;
+                l_rule.m_end = -1;
+                l_rule.m_bndBgn = l_gmr.m_bnds.count ();
+                l_rule.m_bndEnd = -1;
+                l_rlStck << l_gmr.m_rls.count ();
+                l_gmr.m_rls << l_rule;
+            } else if (l_xml.name () == QLatin1String("Bind")) {
+                StringMap l_bnd;
+                foreach (const QXmlStreamAttribute& l_attr, l_attrs)
+                l_bnd.insert (l_attr.name ().toString (),l_attr.value ().toString ());
+
+                l_gmr.m_bnds << l_bnd;
+            }
+        } else if (l_tkn == QXmlStreamReader::EndElement && !l_isRl.isEmpty ()) {
+            if (l_isRl.last ()) {
+                Rule& l_rule = l_gmr.m_rls[l_rlStck.last ()];
+                l_rule.m_end = l_gmr.m_rls.count ();
+                l_rule.m_bndEnd = l_gmr.m_bnds.count ();
+                l_rlStck.pop_back ();
+            }
+
+            l_isRl.pop_back ();
+        }
+    }
+
+    if (l_xml.hasError ()) {
+        if (p_err)
+            *p_err = QString("%1 (line %2, column %3)").arg (l_xml.errorString ()).arg (l_xml.lineNumber ()).arg (l_xml.columnNumber ());
+        return false;
+    }
+
+    p_gmr = l_gmr;
+    return true;
+}
+
+/// @note Like findElement(), every rule below this one is tried, not just its children, each with this rule's prefix.
+const int Grammar::find(const int p_indx, const QString& p_pfx, const QString& p_typ) const {
+    const Rule& l_rule = m_rls.at (p_indx);
+    QString l_pfx = p_pfx;
+
+    if (l_rule.m_hasTyp) {
+        foreach (const QString l_part, l_rule.m_typ.split (",")) {
+            if (Bond::matches (p_typ,l_pfx + l_part) == 1.0)
+                return p_indx;
+        }
+
+        l_pfx.append (l_rule.m_typ);
+    }
+
+    for (int i = p_indx + 1; i < l_rule.m_end; i++) {
+        const int l_fnd = find(i,l_pfx,p_typ);
+        if (l_fnd != -1)
+            return l_fnd;
+    }
+
+    return -1;
+}
+
+const int Grammar::find(const QString& p_typ) const {
+    for (int i = 0; i < m_rls.count (); i++) {
+        const int l_fnd = find(i,QString(),p_typ);
+        if (l_fnd != -1)
+            return l_fnd;
+    }
+
+    return -1;
+}
+
+/// @note Bonds are gathered from the rule outwards, each rule giving every Bind within it, as DomLoadModel::obtainBonds() does.
+void Grammar::loadTo(const int p_indx, Chain& p_chn) const {
+    BondList l_bndVtr;
+    for (int i = p_indx; i != -1; i = m_rls.at (i).m_prnt) {
+        for (int j = m_rls.at (i).m_bndBgn; j < m_rls.at (i).m_bndEnd; j++) {
+            Bond* l_bnd = new Bond;
+            l_bnd->setAttributes (m_bnds.at (j));
+            l_bndVtr << l_bnd;
+        }
+    }
+
+    p_chn.setType (m_rls.at (p_indx).m_fullTyp);
+    p_chn.setBonds (l_bndVtr);
+}
+
+const int Grammar::count() const {
+    return m_rls.count ();
+}
+
 DomStorage::DomStorage() : m_min(DOMSTORAGE_MAXSTR) { }
 
 DomStorage::DomStorage(const Storage &p_str) : Storage(p_str) { }
@@ -425,7 +546,52 @@ QDomElement DomStorage::findElement(const Chain& p_chn, QDomElement p_elem, QStr
     return *(new QDomElement);
 }
 
+const DomStorage::GrammarPointer DomStorage::obtainGrammar(const QString& p_lcl) {
+    const QString l_pth = System::directory () + "/" + p_lcl + "/grammar.xml";
+    const QDateTime l_mtm = QFileInfo(l_pth).lastModified ();
+
+    {
+        QMutexLocker l_lck(&s_gmrMtx);
+        QHash<QString, GrammarEntry>::ConstIterator l_itr = s_gmrs.constFind (l_pth);
+        if (l_itr != s_gmrs.constEnd () && l_itr.value ().m_mtm == l_mtm)
+            return l_itr.value ().m_gmr;
+    }
+
+    QString l_err;
+    GrammarPointer l_gmr(new Grammar);
+    if (!Grammar::load (l_pth,*l_gmr,&l_err)) {
+        qWarning() << "(data) [DomStorage] Can't stream" << l_pth << ":" << l_err << "; falling back to the DOM.";
+        return GrammarPointer();
+    }
+
+    qDebug() << "(data) [DomStorage] Streamed" << l_gmr->count () << "rules of" << p_lcl << ".";
+    GrammarEntry l_ent;
+    l_ent.m_mtm = l_mtm;
+    l_ent.m_gmr = l_gmr;
+
+    QMutexLocker l_lck(&s_gmrMtx);
+    s_gmrs.insert (l_pth,l_ent);
+    return l_gmr;
+}
+
+void DomStorage::clearGrammars() {
+    QMutexLocker l_lck(&s_gmrMtx);
+    s_gmrs.clear ();
+}
+
 void DomStorage::loadTo (Chain &p_chn) const {
+    const GrammarPointer l_gmr = obtainGrammar(p_chn.locale ());
+    if (!l_gmr.isNull ()) {
+        const int l_indx = l_gmr->find (p_chn.type ());
+        if (l_indx == -1) {
+            qWarning() << "(data) [DataStorage] No rule can satisfy.";
+            return;
+        }
+
+        l_gmr->loadTo (l_indx,p_chn);
+        return;
+    }
+
     QDomDocument* l_dom = loadDom (p_chn);
     QDomElement l_elem = findElement(p_chn,l_dom->documentElement());
     if (l_elem.isNull()) {
@@ -474,6 +640,16 @@ const bool Cache::read (Chain &p_chn) {
     return false;
 }
 
+static const Chain readChain(const Chain& p_chn) {
+    Chain l_chn(p_chn);
+    Cache::read (l_chn);
+    return l_chn;
+}
+
+const QFuture<Chain> Cache::readAsync (const Chain& p_chn) {
+    return Async::call (&readChain,p_chn);
+}
+
 void Cache::write (const Chain& p_chn) {
     Storage* l_fdStr;
     foreach (Storage* l_str, Cache::s_stores) {
@@ -515,6 +691,7 @@ void Cache::clearStorage() {
     delete l_str;
 
     s_stores.clear ();
+    DomStorage::clearGrammars ();
 }
 
 
@@ -26,12 +26,18 @@
 
 #include <QMap>
 #include <QList>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QDateTime>
+#include <QSharedPointer>
 #include <QObject>
 #include <QDebug>
 #include <QtDBus/QDBusMetaType>
 #include <QtXml/QDomElement>
 #include <QMetaType>
 #include "linguistics.hpp"
+#include "async.hpp"
 
 namespace Wintermute {
 namespace Data {
@@ -52,6 +58,7 @@ struct DomLoadModel;
 struct DomSaveModel;
 struct DomStorage;
 struct DomBackend;
+struct Grammar;
 
 /**
  * @brief Represents a key-value list of strings.
@@ -710,6 +717,74 @@ private:
 
 };
 
+/**
+ * @brief A locale's grammar.xml, streamed once into flat records.
+ *
+ * The rules are kept in document order, each with the extent of its
+ * descendants, and every Bind in document order too, each rule knowing
+ * the run of Binds it encloses. That's all it takes to answer what the
+ * DOM used to: which rule a type falls under, and which bonds it gathers
+ * from itself and the rules enclosing it.
+ *
+ * @class Grammar rules.hpp "src/rules.hpp"
+ */
+class Grammar {
+private:
+    struct Rule {
+        QString m_typ;     /**< The rule's 'type' attribute, as written. */
+        bool m_hasTyp;     /**< Whether or not the rule has a 'type' attribute. */
+        QString m_fullTyp; /**< The types of the enclosing rules and this one, outermost first. */
+        int m_prnt;        /**< The index of the enclosing rule, or -1. */
+        int m_end;         /**< One past the index of the rule's last descendant. */
+        int m_bndBgn;      /**< The index of the first Bind within the rule. */
+        int m_bndEnd;      /**< One past the index of the last Bind within the rule. */
+    };
+
+    QVector<Rule> m_rls;
+    QVector<StringMap> m_bnds;
+
+    const int find(const int, const QString&, const QString& ) const;
+
+public:
+    /**
+     * @brief Null constructor; a grammar without rules.
+     * @fn Grammar
+     */
+    Grammar();
+
+    /**
+     * @brief Streams a grammar from disk.
+     * @fn load
+     * @param p_pth The path to the grammar.xml.
+     * @param p_gmr The grammar to fill.
+     * @param p_err Set to what went wrong, if anything did.
+     */
+    static const bool load(const QString&, Grammar&, QString* = NULL);
+
+    /**
+     * @brief Finds the rule that a type falls under.
+     * @fn find
+     * @param p_typ The type in question.
+     * @return The index of the rule, or -1 if none can satisfy it.
+     * @note Rules are tried in the same order DomStorage::findElement() walks the DOM.
+     */
+    const int find(const QString& ) const;
+
+    /**
+     * @brief Fills a Chain with the type and bonds of a rule.
+     * @fn loadTo
+     * @param p_indx The index of the rule.
+     * @param p_chn The Chain to fill.
+     */
+    void loadTo(const int, Chain& ) const;
+
+    /**
+     * @brief Obtains the number of rules held.
+     * @fn count
+     */
+    const int count() const;
+};
+
 /**
  * @brief
  *
@@ -763,7 +838,35 @@ public:
      * @fn type
      */
     virtual const QString type () const;
+
+    /**
+     * @brief Drops all of the streamed grammars.
+     * @fn clearGrammars
+     */
+    static void clearGrammars();
 private:
+    typedef QSharedPointer<Grammar> GrammarPointer;
+
+    /**
+     * @brief A streamed grammar and the modification time of the file it came from.
+     */
+    struct GrammarEntry {
+        QDateTime m_mtm;
+        GrammarPointer m_gmr;
+    };
+
+    static QHash<QString, GrammarEntry> s_gmrs; /**< The streamed grammars, keyed by the path of their grammar.xml. */
+    static QMutex s_gmrMtx; /**< Guards s_gmrs. */
+
+    /**
+     * @brief Obtains the grammar of a locale, streaming its grammar.xml only when
+     *        it's not cached or the file changed on disk.
+     * @fn obtainGrammar
+     * @param p_lcl The locale in question.
+     * @return The grammar, or a null pointer if the file can't be streamed.
+     */
+    static const GrammarPointer obtainGrammar(const QString& );
+
     mutable double m_min; /**< Represents the strength of matching. */
     /**
      * @brief
@@ -873,6 +976,15 @@ public:
      * @param
      */
     static const bool read(Chain&);
+
+    /**
+     * @brief Reads a chain on the I/O pool.
+     * @fn readAsync
+     * @param p_chn The chain to read; it's copied.
+     * @return The future of the chain read; on a miss, the chain's handed back as it was passed.
+     * @see Async::then
+     */
+    static const QFuture<Chain> readAsync(const Chain&);
 };
 }
 }
@@ -0,0 +1,754 @@
+/**
+ * @file snapshot.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <QMap>
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <QDir>
+#include <QRunnable>
+#include <QMutexLocker>
+#include "config.hpp"
+#include "snapshot.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+static const char SNAPSHOT_MAGIC[8] = { 'W', 'N', 'T', 'R', 'L', 'E', 'X', '\0' };
+static const quint32 SNAPSHOT_VERSION = 1;
+static const quint32 SNAPSHOT_HEADER = 32;
+static const quint32 SNAPSHOT_IDSIZE = 16;
+
+static void appendU16(QByteArray& p_buf, const quint16 p_val) {
+    uchar l_raw[2];
+    qToLittleEndian<quint16>(p_val, l_raw);
+    p_buf.append((const char*) l_raw, 2);
+}
+
+static void appendU32(QByteArray& p_buf, const quint32 p_val) {
+    uchar l_raw[4];
+    qToLittleEndian<quint32>(p_val, l_raw);
+    p_buf.append((const char*) l_raw, 4);
+}
+
+static void appendString(QByteArray& p_buf, const QString& p_str) {
+    const QByteArray l_utf = p_str.toUtf8();
+    int l_len = l_utf.size();
+
+    // Strings too long for their length field are cut at the last whole codepoint that fits.
+    if (l_len > 0xffff) {
+        l_len = 0xffff;
+        while (l_len > 0 && (((uchar) l_utf.at(l_len)) & 0xc0) == 0x80)
+            l_len--;
+
+        qWarning() << "(data) [Snapshot] Truncated a string of" << l_utf.size() << "bytes to" << l_len << ".";
+    }
+
+    appendU16(p_buf, (quint16) l_len);
+    p_buf.append(l_utf.constData(), l_len);
+}
+
+Snapshot::Snapshot(const QString& p_pth) : m_file(p_pth), m_map(NULL), m_cnt(0),
+        m_ids(NULL), m_offs(NULL), m_syms(NULL), m_flgs(NULL), m_end(NULL), m_sets(), m_setsMtx() {
+    if (!m_file.exists())
+        return;
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "(data) [Snapshot] Can't open" << p_pth << ":" << m_file.errorString();
+        return;
+    }
+
+    const qint64 l_sz = m_file.size();
+    if (l_sz < SNAPSHOT_HEADER) {
+        qWarning() << "(data) [Snapshot] Truncated snapshot" << p_pth << ".";
+        return;
+    }
+
+    // The file stays open for as long as it's mapped.
+    m_map = m_file.map(0, l_sz);
+
+    if (!m_map) {
+        qWarning() << "(data) [Snapshot] Can't map" << p_pth << ".";
+        return;
+    }
+
+    const quint32 l_ver = qFromLittleEndian<quint32>(m_map + 8);
+    const quint32 l_cnt = qFromLittleEndian<quint32>(m_map + 12);
+    const quint32 l_offs = qFromLittleEndian<quint32>(m_map + 16);
+    const quint32 l_syms = qFromLittleEndian<quint32>(m_map + 20);
+    const quint32 l_flgs = qFromLittleEndian<quint32>(m_map + 24);
+    const quint32 l_end = qFromLittleEndian<quint32>(m_map + 28);
+
+    if (memcmp(m_map, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || l_ver != SNAPSHOT_VERSION ||
+            l_end != (quint32) l_sz || l_offs != SNAPSHOT_HEADER + (l_cnt * SNAPSHOT_IDSIZE) ||
+            l_syms != l_offs + (l_cnt * 8) || l_flgs < l_syms || l_end < l_flgs) {
+        qWarning() << "(data) [Snapshot] Invalid snapshot" << p_pth << "; ignoring it.";
+        m_file.unmap(m_map);
+        m_map = NULL;
+        return;
+    }
+
+    m_cnt = l_cnt;
+    m_ids = m_map + SNAPSHOT_HEADER;
+    m_offs = m_map + l_offs;
+    m_syms = m_map + l_syms;
+    m_flgs = m_map + l_flgs;
+    m_end = m_map + l_end;
+}
+
+Snapshot::~Snapshot() {
+    if (m_map)
+        m_file.unmap(m_map);
+}
+
+const bool Snapshot::isValid() const {
+    return m_map != NULL;
+}
+
+const int Snapshot::count() const {
+    return (int) m_cnt;
+}
+
+const int Snapshot::find(const NodeId& p_id) const {
+    if (!isValid())
+        return -1;
+
+    uchar l_raw[SNAPSHOT_IDSIZE];
+    p_id.toBytes(l_raw);
+
+    int l_lo = 0, l_hi = (int) m_cnt - 1;
+    while (l_lo <= l_hi) {
+        const int l_mid = l_lo + ((l_hi - l_lo) / 2);
+        const int l_cmp = memcmp(m_ids + (l_mid * SNAPSHOT_IDSIZE), l_raw, SNAPSHOT_IDSIZE);
+        if (l_cmp == 0)
+            return l_mid;
+        else if (l_cmp < 0)
+            l_lo = l_mid + 1;
+        else
+            l_hi = l_mid - 1;
+    }
+
+    return -1;
+}
+
+const int Snapshot::upperBound(const NodeId& p_id) const {
+    if (!isValid() || p_id.isNull())
+        return 0;
+
+    uchar l_raw[SNAPSHOT_IDSIZE];
+    p_id.toBytes(l_raw);
+
+    int l_lo = 0, l_hi = (int) m_cnt;
+    while (l_lo < l_hi) {
+        const int l_mid = l_lo + ((l_hi - l_lo) / 2);
+        if (memcmp(m_ids + (l_mid * SNAPSHOT_IDSIZE), l_raw, SNAPSHOT_IDSIZE) <= 0)
+            l_lo = l_mid + 1;
+        else
+            l_hi = l_mid;
+    }
+
+    return l_lo;
+}
+
+const NodeId Snapshot::idAt(const int p_indx) const {
+    if (p_indx < 0 || p_indx >= (int) m_cnt)
+        return NodeId();
+
+    return NodeId::fromBytes(m_ids + (p_indx * SNAPSHOT_IDSIZE));
+}
+
+const QString Snapshot::readString(const uchar*& p_ptr) const {
+    if (p_ptr + 2 > m_end)
+        return QString::null;
+
+    const quint16 l_len = qFromLittleEndian<quint16>(p_ptr);
+    p_ptr += 2;
+
+    if (p_ptr + l_len > m_end)
+        return QString::null;
+
+    const QString l_str = QString::fromUtf8((const char*) p_ptr, l_len);
+    p_ptr += l_len;
+    return l_str;
+}
+
+const bool Snapshot::loadTo(const int p_indx, Node& p_nd) const {
+    if (p_indx < 0 || p_indx >= (int) m_cnt)
+        return false;
+
+    const uchar* l_off = m_offs + (p_indx * 8);
+    const quint32 l_flgOff = qFromLittleEndian<quint32>(l_off + 4);
+    const uchar* l_sym = m_syms + qFromLittleEndian<quint32>(l_off);
+    const uchar* l_flg = m_flgs + l_flgOff;
+
+    if (l_sym >= m_flgs || l_flg + 2 > m_end) {
+        qWarning() << "(data) [Snapshot] Corrupted entry" << p_indx << ".";
+        return false;
+    }
+
+    const QString l_symbol = readString(l_sym);
+
+    // Nodes with the same flags share one entry of the flag section, so each is decoded once.
+    {
+        QMutexLocker l_lck(&m_setsMtx);
+        const QHash<quint32, const FlagList*>::ConstIterator l_itr = m_sets.constFind(l_flgOff);
+        if (l_itr != m_sets.constEnd()) {
+            p_nd = Node(p_nd.nodeId(), p_nd.localeAtom(), l_symbol, l_itr.value());
+            return true;
+        }
+    }
+
+    const quint16 l_cnt = qFromLittleEndian<quint16>(l_flg);
+    l_flg += 2;
+
+    FlagList l_flgs;
+    l_flgs.reserve(l_cnt);
+    for (quint16 i = 0; i < l_cnt; i++) {
+        const QString l_guid = readString(l_flg);
+        const QString l_link = readString(l_flg);
+        l_flgs.append(Flag(l_guid, l_link));
+    }
+
+    p_nd = Node(p_nd.nodeId(), p_nd.localeAtom(), l_symbol, FlagSets::intern(l_flgs));
+
+    QMutexLocker l_lck(&m_setsMtx);
+    m_sets.insert(l_flgOff, &p_nd.flagList());
+    return true;
+}
+
+const bool Snapshot::loadTo(const int p_indx, Data& p_dt) const {
+    Node l_nd(p_dt.node());
+    if (!loadTo(p_indx, l_nd))
+        return false;
+
+    p_dt.setNode(l_nd);
+    return true;
+}
+
+const bool Snapshot::write(const QString& p_pth, const QList<Node>& p_nodes) {
+    // IDs sort exactly like the raw digests; later nodes win.
+    QMap<NodeId, int> l_sorted;
+    for (int i = 0; i < p_nodes.count(); i++) {
+        const NodeId l_id = p_nodes.at(i).nodeId();
+        if (l_id.isNull()) {
+            qWarning() << "(data) [Snapshot] Skipping node without an ID" << p_nodes.at(i).symbol();
+            continue;
+        }
+
+        l_sorted.insert(l_id, i);
+    }
+
+    QByteArray l_ids, l_offs, l_syms, l_flgs;
+    QHash<QByteArray, quint32> l_sets;
+    l_ids.reserve(l_sorted.count() * SNAPSHOT_IDSIZE);
+    l_offs.reserve(l_sorted.count() * 8);
+
+    QMap<NodeId, int>::ConstIterator l_itr = l_sorted.constBegin(), l_end = l_sorted.constEnd();
+    for (; l_itr != l_end; ++l_itr) {
+        const Node& l_nd = p_nodes.at(l_itr.value());
+        uchar l_raw[SNAPSHOT_IDSIZE];
+        l_itr.key().toBytes(l_raw);
+        l_ids.append((const char*) l_raw, SNAPSHOT_IDSIZE);
+
+        const FlagList& l_flgLst = l_nd.flagList();
+        QByteArray l_set;
+        appendU16(l_set, (quint16) l_flgLst.count());
+        for (int j = 0; j < l_flgLst.count(); j++) {
+            appendString(l_set, l_flgLst.at(j).guid());
+            appendString(l_set, l_flgLst.at(j).link());
+        }
+
+        // Identical flag sets are written once; every node carrying one points at the same entry.
+        QHash<QByteArray, quint32>::ConstIterator l_setItr = l_sets.constFind(l_set);
+        if (l_setItr == l_sets.constEnd()) {
+            l_setItr = l_sets.insert(l_set, (quint32) l_flgs.size());
+            l_flgs.append(l_set);
+        }
+
+        appendU32(l_offs, (quint32) l_syms.size());
+        appendU32(l_offs, l_setItr.value());
+        appendString(l_syms, l_nd.symbol());
+    }
+
+    const quint32 l_cnt = (quint32) l_sorted.count();
+    const quint32 l_offsAt = SNAPSHOT_HEADER + l_ids.size();
+    const quint32 l_symsAt = l_offsAt + l_offs.size();
+    const quint32 l_flgsAt = l_symsAt + l_syms.size();
+    const quint32 l_size = l_flgsAt + l_flgs.size();
+
+    QByteArray l_hdr(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    appendU32(l_hdr, SNAPSHOT_VERSION);
+    appendU32(l_hdr, l_cnt);
+    appendU32(l_hdr, l_offsAt);
+    appendU32(l_hdr, l_symsAt);
+    appendU32(l_hdr, l_flgsAt);
+    appendU32(l_hdr, l_size);
+
+    const QString l_tmpPth = p_pth + ".tmp";
+    QFile l_file(l_tmpPth);
+    if (!l_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "(data) [Snapshot] Can't write" << l_tmpPth << ":" << l_file.errorString();
+        return false;
+    }
+
+    l_file.write(l_hdr);
+    l_file.write(l_ids);
+    l_file.write(l_offs);
+    l_file.write(l_syms);
+    l_file.write(l_flgs);
+    l_file.close();
+
+    if (l_file.error() != QFile::NoError) {
+        qWarning() << "(data) [Snapshot] Failed writing" << l_tmpPth << ":" << l_file.errorString();
+        QFile::remove(l_tmpPth);
+        return false;
+    }
+
+    // Removing the old file leaves any existing mapping intact until it's unmapped.
+    QFile::remove(p_pth);
+    if (!QFile::rename(l_tmpPth, p_pth)) {
+        qWarning() << "(data) [Snapshot] Can't move snapshot into" << p_pth << ".";
+        return false;
+    }
+
+    qDebug() << "(data) [Snapshot] Wrote" << l_cnt << "nodes (" << l_size << "bytes) to" << p_pth;
+    return true;
+}
+
+/**
+ * @brief Folds a locale's journaled nodes into its learned snapshot.
+ * @class SnapshotCompactor snapshot.cpp "src/snapshot.cpp"
+ */
+class SnapshotCompactor : public QRunnable {
+private:
+    SnapshotStorage* m_strg;
+    const QString m_lcl;
+
+public:
+    SnapshotCompactor(SnapshotStorage* p_strg, const QString& p_lcl) : QRunnable(), m_strg(p_strg), m_lcl(p_lcl) { }
+
+    virtual void run() {
+        m_strg->compact(m_lcl);
+    }
+};
+
+SnapshotStorage::Layers::Layers() : m_wrtn(), m_frzn(), m_lrnd(), m_base(), m_jrnl(), m_cmpctng(false) { }
+
+SnapshotStorage::SnapshotStorage() : Storage(), m_lyrs(), m_mtx(), m_pool() {
+    m_pool.setMaxThreadCount(1);
+}
+
+SnapshotStorage::~SnapshotStorage() {
+    m_pool.waitForDone();
+}
+
+void SnapshotStorage::settle() {
+    m_pool.waitForDone();
+}
+
+/// @note Like generate(), this only lets go of the base snapshot; it's mapped anew on the next lookup.
+const bool SnapshotStorage::prepare(const QString& p_lcl) {
+    QMutexLocker l_lck(&m_mtx);
+    QHash<QString, Layers>::Iterator l_itr = m_lyrs.find(p_lcl);
+    if (l_itr != m_lyrs.end())
+        l_itr.value().m_base.clear();
+
+    return false;
+}
+
+/// @note Whatever was journaled stays on disk and is replayed when the locale's next used.
+void SnapshotStorage::release(const QString& p_lcl) {
+    m_pool.waitForDone();
+    QMutexLocker l_lck(&m_mtx);
+    m_lyrs.remove(p_lcl);
+}
+
+const QString SnapshotStorage::getPath(const QString& p_lcl) {
+    return System::directory() + QString("/") + p_lcl + QString("/node.snapshot");
+}
+
+const QString SnapshotStorage::getLearnedPath(const QString& p_lcl) {
+    return System::directory() + QString("/") + p_lcl + QString("/node.learned");
+}
+
+const QString SnapshotStorage::getJournalPath(const QString& p_lcl) {
+    return System::directory() + QString("/") + p_lcl + QString("/node.journal");
+}
+
+const QString SnapshotStorage::type() const {
+    return "Snapshot";
+}
+
+/// @note Files are replaced by removing the old one and renaming a complete '.tmp' over it;
+///       a '.tmp' found without its file means we crashed in between, so it's promoted.
+void SnapshotStorage::recover(const QString& p_lcl) {
+    QStringList l_pths;
+    l_pths << getLearnedPath(p_lcl) << getJournalPath(p_lcl);
+
+    foreach (const QString l_pth, l_pths) {
+        const QString l_tmpPth = l_pth + ".tmp";
+        if (!QFile::exists(l_tmpPth))
+            continue;
+
+        if (QFile::exists(l_pth))
+            QFile::remove(l_tmpPth);
+        else {
+            qWarning() << "(data) [SnapshotStorage] Recovering" << l_pth << "from an interrupted compaction.";
+            QFile::rename(l_tmpPth, l_pth);
+        }
+    }
+}
+
+/// @note Expects m_mtx to be held; the first access of a locale replays its journal.
+SnapshotStorage::Layers& SnapshotStorage::layers(const QString& p_lcl) const {
+    QHash<QString, Layers>::Iterator l_itr = m_lyrs.find(p_lcl);
+    if (l_itr == m_lyrs.end()) {
+        recover(p_lcl);
+
+        Layers l_lyrs;
+        Journal::replay(getJournalPath(p_lcl), p_lcl, l_lyrs.m_wrtn);
+        l_lyrs.m_jrnl = JournalPointer(new Journal(getJournalPath(p_lcl)));
+        l_lyrs.m_lrnd = SnapshotPointer(new Snapshot(getLearnedPath(p_lcl)));
+        l_itr = m_lyrs.insert(p_lcl, l_lyrs);
+    }
+
+    // Invalid snapshots are kept around too, so a missing file isn't probed on every lookup.
+    if (l_itr.value().m_base.isNull())
+        l_itr.value().m_base = SnapshotPointer(new Snapshot(getPath(p_lcl)));
+
+    return l_itr.value();
+}
+
+/// @note Expects m_mtx to be held.
+const Node* SnapshotStorage::journaled(const Layers& p_lyrs, const NodeId& p_id) {
+    QHash<NodeId, Node>::ConstIterator l_itr = p_lyrs.m_wrtn.constFind(p_id);
+    if (l_itr != p_lyrs.m_wrtn.constEnd())
+        return &l_itr.value();
+
+    l_itr = p_lyrs.m_frzn.constFind(p_id);
+    if (l_itr != p_lyrs.m_frzn.constEnd())
+        return &l_itr.value();
+
+    return NULL;
+}
+
+/// @note The snapshots are immutable once mapped, so they're searched outside of the lock.
+const bool SnapshotStorage::findSnapshotted(const SnapshotPointer& p_lrnd, const SnapshotPointer& p_base, const NodeId& p_id, Data* p_out) {
+    const SnapshotPointer l_snpshts[2] = { p_lrnd, p_base };
+    for (int i = 0; i < 2; i++) {
+        const int l_indx = l_snpshts[i]->find(p_id);
+        if (l_indx == -1)
+            continue;
+
+        if (p_out)
+            l_snpshts[i]->loadTo(l_indx, *p_out);
+
+        return true;
+    }
+
+    return false;
+}
+
+const bool SnapshotStorage::find(const Data& p_dt, Data* p_out) const {
+    SnapshotPointer l_lrnd, l_base;
+
+    {
+        QMutexLocker l_lck(&m_mtx);
+        const Layers& l_lyrs = layers(p_dt.locale());
+
+        const Node* l_fnd = journaled(l_lyrs, p_dt.nodeId());
+        if (l_fnd) {
+            if (p_out)
+                p_out->setNode(*l_fnd);
+
+            return true;
+        }
+
+        l_lrnd = l_lyrs.m_lrnd;
+        l_base = l_lyrs.m_base;
+    }
+
+    return findSnapshotted(l_lrnd, l_base, p_dt.nodeId(), p_out);
+}
+
+/// @note The journaled layers of the whole batch are checked under one lock.
+void SnapshotStorage::loadBatch(QList<Data>& p_nodes, QVector<bool>& p_fnd) const {
+    QList<int> l_rst;
+    QList<QPair<SnapshotPointer, SnapshotPointer> > l_snpshts;
+
+    {
+        QMutexLocker l_lck(&m_mtx);
+        for (int i = 0; i < p_nodes.count(); i++) {
+            if (p_fnd.at(i))
+                continue;
+
+            const Layers& l_lyrs = layers(p_nodes.at(i).locale());
+            const Node* l_fnd = journaled(l_lyrs, p_nodes.at(i).nodeId());
+            if (l_fnd) {
+                p_nodes[i].setNode(*l_fnd);
+                p_fnd[i] = true;
+                continue;
+            }
+
+            l_rst << i;
+            l_snpshts << qMakePair(l_lyrs.m_lrnd, l_lyrs.m_base);
+        }
+    }
+
+    for (int i = 0; i < l_rst.count(); i++) {
+        Data& l_dt = p_nodes[l_rst.at(i)];
+        if (findSnapshotted(l_snpshts.at(i).first, l_snpshts.at(i).second, l_dt.nodeId(), &l_dt))
+            p_fnd[l_rst.at(i)] = true;
+    }
+}
+
+const bool SnapshotStorage::exists(const Data& p_dt) const {
+    return find(p_dt, NULL);
+}
+
+void SnapshotStorage::loadTo(Data& p_dt) const {
+    find(p_dt, &p_dt);
+}
+
+void SnapshotStorage::saveFrom(const Data& p_dt) {
+    QList<Data> l_nodes;
+    l_nodes << p_dt;
+    saveBatch(l_nodes, DurabilityFlush);
+}
+
+/// @note Each locale's share of the batch is journaled with a single write.
+const bool SnapshotStorage::saveBatch(const QList<Data>& p_nodes, const Durability p_drblty) {
+    bool l_ok = true;
+    QHash<QString, QList<Node> > l_byLcl;
+    foreach (const Data& l_dt, p_nodes)
+        l_byLcl[l_dt.locale()] << l_dt.node();
+
+    QMutexLocker l_lck(&m_mtx);
+    for (QHash<QString, QList<Node> >::ConstIterator l_itr = l_byLcl.constBegin(); l_itr != l_byLcl.constEnd(); ++l_itr) {
+        const QString l_lcl = l_itr.key();
+        Layers& l_lyrs = layers(l_lcl);
+
+        if (!QDir().mkpath(System::directory() + QString("/") + l_lcl) || !l_lyrs.m_jrnl->open()) {
+            l_ok = false;
+            continue;
+        }
+
+        // The records are on their way to disk before the nodes are visible.
+        if (!l_lyrs.m_jrnl->append(l_itr.value(), p_drblty)) {
+            l_ok = false;
+            continue;
+        }
+
+        foreach (const Node& l_nd, l_itr.value())
+            l_lyrs.m_wrtn.insert(l_nd.nodeId(), l_nd);
+
+        if (!l_lyrs.m_cmpctng && l_lyrs.m_jrnl->size() > WNTRDATA_JOURNAL_LIMIT)
+            beginCompaction(l_lcl, l_lyrs);
+    }
+
+    return l_ok;
+}
+
+/// @note Expects m_mtx to be held. Writes keep landing in m_wrtn (and the journal) while m_frzn's compacted.
+void SnapshotStorage::beginCompaction(const QString& p_lcl, Layers& p_lyrs) {
+    qDebug() << "(data) [SnapshotStorage] Compacting" << p_lyrs.m_wrtn.count() << "journaled nodes of" << p_lcl;
+    p_lyrs.m_cmpctng = true;
+    p_lyrs.m_frzn = p_lyrs.m_wrtn;
+    p_lyrs.m_wrtn.clear();
+    m_pool.start(new SnapshotCompactor(this, p_lcl));
+}
+
+void SnapshotStorage::compact(const QString& p_lcl) {
+    QHash<NodeId, Node> l_frzn;
+    SnapshotPointer l_lrnd;
+
+    {
+        QMutexLocker l_lck(&m_mtx);
+        const Layers& l_lyrs = layers(p_lcl);
+        l_frzn = l_lyrs.m_frzn;
+        l_lrnd = l_lyrs.m_lrnd;
+    }
+
+    QList<Node> l_nodes;
+    l_nodes.reserve(l_lrnd->count() + l_frzn.count());
+    for (int i = 0; i < l_lrnd->count(); i++) {
+        Node l_nd(l_lrnd->idAt(i), Atoms::intern(p_lcl), QString(), NULL);
+        if (l_lrnd->loadTo(i, l_nd))
+            l_nodes << l_nd;
+    }
+
+    // Later nodes win in Snapshot::write(), so the frozen ones override what was learned earlier.
+    l_nodes << l_frzn.values();
+
+    const bool l_wrttn = Snapshot::write(getLearnedPath(p_lcl), l_nodes);
+    const SnapshotPointer l_nwLrnd(l_wrttn ? new Snapshot(getLearnedPath(p_lcl)) : NULL);
+
+    QMutexLocker l_lck(&m_mtx);
+    Layers& l_lyrs = layers(p_lcl);
+    l_lyrs.m_cmpctng = false;
+
+    if (!l_wrttn || !l_nwLrnd->isValid()) {
+        // The journal still holds every record, so the frozen nodes just go back to being journaled.
+        qWarning() << "(data) [SnapshotStorage] Compaction of" << p_lcl << "failed; keeping the journal.";
+        for (QHash<NodeId, Node>::ConstIterator l_itr = l_frzn.constBegin(); l_itr != l_frzn.constEnd(); ++l_itr) {
+            if (!l_lyrs.m_wrtn.contains(l_itr.key()))
+                l_lyrs.m_wrtn.insert(l_itr.key(), l_itr.value());
+        }
+
+        l_lyrs.m_frzn.clear();
+        return;
+    }
+
+    l_lyrs.m_lrnd = l_nwLrnd;
+    l_lyrs.m_frzn.clear();
+
+    // Rewrite the journal down to what was written during the compaction.
+    const QString l_pth = getJournalPath(p_lcl);
+    const QString l_tmpPth = l_pth + ".tmp";
+    QFile::remove(l_tmpPth);
+
+    bool l_ok = true;
+    {
+        Journal l_tmp(l_tmpPth);
+        l_ok = l_tmp.open();
+        for (QHash<NodeId, Node>::ConstIterator l_itr = l_lyrs.m_wrtn.constBegin(); l_ok && l_itr != l_lyrs.m_wrtn.constEnd(); ++l_itr)
+            l_ok = l_tmp.append(l_itr.value());
+    }
+
+    if (!l_ok) {
+        QFile::remove(l_tmpPth);
+        return;
+    }
+
+    l_lyrs.m_jrnl->close();
+    QFile::remove(l_pth);
+    QFile::rename(l_tmpPth, l_pth);
+    l_lyrs.m_jrnl->open();
+
+    qDebug() << "(data) [SnapshotStorage] Compacted" << p_lcl << "into" << l_nwLrnd->count() << "learned nodes.";
+}
+
+/// @note DomStorage::generate() emits the base snapshots; we drop ours so they're re-mapped on next use.
+///       Learned nodes and journals aren't touched; they're not derived from node.xml.
+void SnapshotStorage::generate() {
+    QMutexLocker l_lck(&m_mtx);
+    for (QHash<QString, Layers>::Iterator l_itr = m_lyrs.begin(); l_itr != m_lyrs.end(); ++l_itr)
+        l_itr.value().m_base.clear();
+}
+
+const bool SnapshotStorage::hasPseudo(const Data& p_dt) const {
+    Q_UNUSED(p_dt);
+    return false;
+}
+
+void SnapshotStorage::loadPseudo(Data& p_dt) const {
+    Q_UNUSED(p_dt);
+}
+
+const QString SnapshotStorage::obtainFullSuffix(const QString& p_lcl, const QString& p_sfx) const {
+    Q_UNUSED(p_lcl);
+    Q_UNUSED(p_sfx);
+    return "";
+}
+
+const bool SnapshotStorage::nodes(const QString& p_lcl, NodeIdList& p_ids) const {
+    SnapshotPointer l_snpshts[2];
+
+    {
+        QMutexLocker l_lck(&m_mtx);
+        const Layers& l_lyrs = layers(p_lcl);
+        p_ids << l_lyrs.m_wrtn.keys() << l_lyrs.m_frzn.keys();
+        l_snpshts[0] = l_lyrs.m_lrnd;
+        l_snpshts[1] = l_lyrs.m_base;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < l_snpshts[i]->count(); j++)
+            p_ids << l_snpshts[i]->idAt(j);
+    }
+
+    return true;
+}
+
+const bool SnapshotStorage::isJournaled() const {
+    return true;
+}
+
+/// @note The journaled IDs are few (the journal's bounded), so they're sorted per page; the snapshots already are.
+const bool SnapshotStorage::scan(const QString& p_lcl, const NodeId& p_aftr, const int p_lmt, NodeIdList& p_ids) const {
+    NodeIdList l_jrnld;
+    SnapshotPointer l_snpshts[2];
+
+    {
+        QMutexLocker l_lck(&m_mtx);
+        const Layers& l_lyrs = layers(p_lcl);
+        const NodeIdList l_keys = NodeIdList() << l_lyrs.m_wrtn.keys() << l_lyrs.m_frzn.keys();
+        foreach (const NodeId& l_id, l_keys) {
+            if (p_aftr.isNull() || p_aftr < l_id)
+                l_jrnld << l_id;
+        }
+
+        l_snpshts[0] = l_lyrs.m_lrnd;
+        l_snpshts[1] = l_lyrs.m_base;
+    }
+
+    qSort(l_jrnld);
+    l_jrnld.erase(std::unique(l_jrnld.begin(), l_jrnld.end()), l_jrnld.end());
+
+    int l_pos[3] = { 0, l_snpshts[0]->upperBound(p_aftr), l_snpshts[1]->upperBound(p_aftr) };
+    const int l_ends[3] = { l_jrnld.count(), l_snpshts[0]->count(), l_snpshts[1]->count() };
+    NodeId l_heads[3];
+
+    while (p_ids.count() < p_lmt) {
+        // Merge the three sorted runs, taking the smallest head and skipping it in every run that holds it.
+        int l_min = -1;
+        for (int i = 0; i < 3; i++) {
+            if (l_pos[i] >= l_ends[i])
+                continue;
+
+            l_heads[i] = (i == 0) ? l_jrnld.at(l_pos[i]) : l_snpshts[i - 1]->idAt(l_pos[i]);
+            if (l_min == -1 || l_heads[i] < l_heads[l_min])
+                l_min = i;
+        }
+
+        if (l_min == -1)
+            break;
+
+        const NodeId l_id = l_heads[l_min];
+        p_ids << l_id;
+
+        for (int i = 0; i < 3; i++) {
+            if (l_pos[i] < l_ends[i] && l_heads[i] == l_id)
+                l_pos[i]++;
+        }
+    }
+
+    return true;
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
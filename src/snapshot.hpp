@@ -0,0 +1,263 @@
+/**
+ * @file snapshot.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <QHash>
+#include <QFile>
+#include <QMutex>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include "lexical.hpp"
+#include "journal.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct Snapshot;
+struct SnapshotStorage;
+
+/**
+ * @brief A read-only, memory-mapped image of a locale's lexicon.
+ *
+ * Snapshots are emitted by DomStorage::generate() next to the locale's
+ * <tt>node.xml</tt> as <tt>node.snapshot</tt>. The file is laid out as
+ * follows (all integers are little-endian):
+ *
+ * @code
+ * header  : char[8] "WNTRLEX", quint32 version, quint32 count,
+ *           quint32 offsets, quint32 symbols, quint32 flags, quint32 size
+ * ids     : count * 16 bytes, raw MD5 digests sorted ascending
+ * offsets : count * (quint32 symbol offset, quint32 flag offset)
+ * symbols : per node, quint16 length + UTF-8 bytes
+ * flags   : per distinct flag set, quint16 count + count * (guid, link) strings
+ * @endcode
+ *
+ * Nodes carrying identical flags share a single entry of the flag
+ * section, and the decoded set is shared in memory through FlagSets.
+ *
+ * Looking up a node is a binary search over the ID table; no file is
+ * opened and no XML is parsed once the snapshot's been mapped.
+ *
+ * @class Snapshot snapshot.hpp "src/snapshot.hpp"
+ */
+class Snapshot {
+    Q_DISABLE_COPY(Snapshot)
+
+private:
+    QFile m_file;
+    uchar* m_map;
+    quint32 m_cnt;
+    const uchar* m_ids;
+    const uchar* m_offs;
+    const uchar* m_syms;
+    const uchar* m_flgs;
+    const uchar* m_end;
+    mutable QHash<quint32, const FlagList*> m_sets;
+    mutable QMutex m_setsMtx;
+
+    const QString readString(const uchar*&) const;
+
+public:
+    /**
+     * @brief Maps the snapshot at the specified path.
+     * @fn Snapshot
+     * @param p_pth The path to the snapshot file.
+     */
+    explicit Snapshot(const QString& );
+
+    /**
+     * @brief Deconstructor; unmaps the snapshot.
+     * @fn ~Snapshot
+     */
+    ~Snapshot();
+
+    /**
+     * @brief Determines if the snapshot was mapped and passed validation.
+     * @fn isValid
+     */
+    const bool isValid() const;
+
+    /**
+     * @brief Obtains the number of nodes held in this snapshot.
+     * @fn count
+     */
+    const int count() const;
+
+    /**
+     * @brief Finds the index of a node by its ID.
+     * @fn find
+     * @param p_id The ID of the node.
+     * @return The index of the node, or -1 if it's not held here.
+     */
+    const int find(const NodeId& ) const;
+
+    /**
+     * @brief Finds the index of the first node whose ID sorts after the specified one.
+     * @fn upperBound
+     * @param p_id The ID to start after; the null ID starts at the beginning.
+     * @return The index, which is count() if no node sorts after it.
+     */
+    const int upperBound(const NodeId& ) const;
+
+    /**
+     * @brief Obtains the ID of the node at the specified index.
+     * @fn idAt
+     * @param p_indx The index of the node.
+     */
+    const NodeId idAt(const int ) const;
+
+    /**
+     * @brief Fills the symbol and flags of a Node from the node at the specified index.
+     * @fn loadTo
+     * @param p_indx The index of the node.
+     * @param p_nd The Node to fill.
+     */
+    const bool loadTo(const int, Node& ) const;
+
+    /**
+     * @brief Fills the symbol and flags of a Data from the node at the specified index.
+     * @fn loadTo
+     * @param p_indx The index of the node.
+     * @param p_dt The Data to fill.
+     */
+    const bool loadTo(const int, Data& ) const;
+
+    /**
+     * @brief Writes a snapshot of the specified nodes to disk.
+     * @fn write
+     * @param p_pth The path to write the snapshot to.
+     * @param p_nodes The nodes to be written.
+     * @note The snapshot is written to a temporary file first and then
+     *       moved over the old one, so mapped readers are never torn.
+     */
+    static const bool write(const QString&, const QList<Node>& );
+};
+
+/**
+ * @brief Represents a Storage served from per-locale Snapshots and Journals.
+ *
+ * Each locale is served from a set of layers, newest first: the nodes
+ * journaled since the last compaction, the nodes being compacted, the
+ * <tt>node.learned</tt> snapshot of nodes compacted earlier and finally
+ * the <tt>node.snapshot</tt> spawned from the locale's <tt>node.xml</tt>.
+ *
+ * Writes are appended to the locale's <tt>node.journal</tt> and become
+ * visible right away; once the journal outgrows WNTRDATA_JOURNAL_LIMIT a
+ * background compactor folds it into <tt>node.learned</tt>. The layers are
+ * loaded lazily on first access, which is when a journal left behind by a
+ * crash is replayed.
+ *
+ * @class SnapshotStorage snapshot.hpp "src/snapshot.hpp"
+ */
+class SnapshotStorage : public Storage {
+    friend class SnapshotCompactor;
+    typedef QSharedPointer<Snapshot> SnapshotPointer;
+    typedef QSharedPointer<Journal> JournalPointer;
+
+    /**
+     * @brief The layers of a locale.
+     */
+    struct Layers {
+        Layers();
+        QHash<NodeId, Node> m_wrtn; /**< Nodes journaled since the last compaction began. */
+        QHash<NodeId, Node> m_frzn; /**< Nodes being folded into m_lrnd. */
+        SnapshotPointer m_lrnd; /**< Nodes learned through writes and compacted. */
+        SnapshotPointer m_base; /**< Nodes spawned from the locale's node.xml. */
+        JournalPointer m_jrnl; /**< The journal holding m_wrtn. */
+        bool m_cmpctng; /**< Whether or not a compaction's underway. */
+    };
+
+private:
+    mutable QHash<QString, Layers> m_lyrs;
+    mutable QMutex m_mtx;
+    QThreadPool m_pool;
+
+    Layers& layers(const QString& ) const;
+    const bool find(const Data&, Data* ) const;
+    static const Node* journaled(const Layers&, const NodeId& );
+    static const bool findSnapshotted(const SnapshotPointer&, const SnapshotPointer&, const NodeId&, Data* );
+    void beginCompaction(const QString&, Layers& );
+    void compact(const QString& );
+    static void recover(const QString& );
+
+public:
+    /**
+     * @brief Null constructor.
+     * @fn SnapshotStorage
+     */
+    SnapshotStorage();
+
+    /**
+     * @brief Deconstructor; waits for any compaction to finish.
+     * @fn ~SnapshotStorage
+     */
+    virtual ~SnapshotStorage();
+
+    /**
+     * @brief Obtains the path of the snapshot for the specified locale.
+     * @fn getPath
+     * @param p_lcl The locale in question.
+     */
+    static const QString getPath(const QString& );
+
+    /**
+     * @brief Obtains the path of the learned snapshot for the specified locale.
+     * @fn getLearnedPath
+     * @param p_lcl The locale in question.
+     */
+    static const QString getLearnedPath(const QString& );
+
+    /**
+     * @brief Obtains the path of the journal for the specified locale.
+     * @fn getJournalPath
+     * @param p_lcl The locale in question.
+     */
+    static const QString getJournalPath(const QString& );
+
+    virtual const QString type() const;
+    virtual const bool exists(const Data& ) const;
+    virtual void loadTo(Data& ) const;
+    virtual void saveFrom(const Data& );
+    virtual const bool saveBatch(const QList<Data>&, const Durability = DurabilityFlush);
+    virtual void loadBatch(QList<Data>&, QVector<bool>& ) const;
+    virtual void generate();
+    virtual const bool hasPseudo(const Data& ) const;
+    virtual void loadPseudo(Data& ) const;
+    virtual const QString obtainFullSuffix(const QString&, const QString& ) const;
+    virtual const bool nodes(const QString&, NodeIdList& ) const;
+    virtual const bool isJournaled() const;
+    virtual const bool scan(const QString&, const NodeId&, const int, NodeIdList& ) const;
+    virtual void settle();
+    virtual const bool prepare(const QString& );
+    virtual void release(const QString& );
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,539 @@
+/**
+ * @file sqlite.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QDataStream>
+#include <QStringList>
+#include <QVariantList>
+#include <QCryptographicHash>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include "sqlite.hpp"
+#include "nodexml.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+QThreadStorage<SqliteStorage::ConnectionSet*> SqliteStorage::s_cnxs;
+QAtomicInt SqliteStorage::s_cnxCnt(0);
+
+/// @note node.xml is hashed in blocks of this many bytes, so it's never held whole.
+static const int SQLITESTORAGE_READ_BLOCK = 65536;
+
+/// @note How long, in milliseconds, a connection waits on another's write before giving up.
+static const int SQLITESTORAGE_BUSY_TIMEOUT = 5000;
+
+/// @note Ordered like SqliteStorage::Statement.
+static const char* const SQLITESTORAGE_STATEMENTS[] = {
+    "SELECT symbol, flags FROM nodes WHERE locale = ? AND id = ?",
+    "INSERT OR REPLACE INTO nodes (locale, id, symbol, flags, learned) VALUES (?, ?, ?, ?, 1)",
+    "SELECT flags FROM pseudos WHERE locale = ?",
+    "SELECT full FROM suffixes WHERE locale = ? AND suffix = ?",
+    "SELECT id FROM nodes WHERE locale = ? ORDER BY id",
+    "SELECT id FROM nodes WHERE locale = ? AND id > ? ORDER BY id LIMIT ?"
+};
+
+static const char* const SQLITESTORAGE_SCHEMA[] = {
+    "PRAGMA journal_mode = WAL",
+    "PRAGMA synchronous = NORMAL",
+    "CREATE TABLE IF NOT EXISTS nodes (locale TEXT NOT NULL, id BLOB NOT NULL, symbol TEXT NOT NULL, flags BLOB NOT NULL, "
+    "learned INTEGER NOT NULL DEFAULT 0, PRIMARY KEY (locale, id))",
+    "CREATE TABLE IF NOT EXISTS pseudos (locale TEXT PRIMARY KEY, flags BLOB NOT NULL)",
+    "CREATE TABLE IF NOT EXISTS suffixes (locale TEXT NOT NULL, suffix TEXT NOT NULL, full TEXT NOT NULL, PRIMARY KEY (locale, suffix))",
+    "CREATE TABLE IF NOT EXISTS sources (locale TEXT PRIMARY KEY, digest TEXT NOT NULL)",
+    NULL
+};
+
+/// @note Raw IDs compare like NodeIds do, so 'ORDER BY id' is the order scan() pages in.
+static const QByteArray toBlob(const NodeId& p_id) {
+    QByteArray l_blob(16, 0);
+    p_id.toBytes((uchar*) l_blob.data());
+    return l_blob;
+}
+
+/// @note Used for the statements run once per import; the ones run per lookup stay prepared.
+static const bool runQuery(QSqlQuery& p_qry, const QString& p_sql, const QVariantList& p_vals) {
+    if (!p_qry.prepare(p_sql)) {
+        qWarning() << "(data) [SqliteStorage] Can't prepare" << p_sql << ":" << p_qry.lastError().text();
+        return false;
+    }
+
+    foreach (const QVariant& l_val, p_vals)
+        p_qry.addBindValue(l_val);
+
+    if (!p_qry.exec()) {
+        qWarning() << "(data) [SqliteStorage] Can't run" << p_sql << ":" << p_qry.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+SqliteStorage::Connection::Connection() : m_name() {
+    for (int i = 0; i < StatementCount; i++)
+        m_stmts[i] = NULL;
+}
+
+SqliteStorage::Connection::~Connection() {
+    for (int i = 0; i < StatementCount; i++)
+        delete m_stmts[i];
+
+    // Every handle on the connection has to be gone before it's removed.
+    {
+        QSqlDatabase l_db = QSqlDatabase::database(m_name, false);
+        l_db.close();
+    }
+
+    QSqlDatabase::removeDatabase(m_name);
+}
+
+SqliteStorage::ConnectionSet::~ConnectionSet() {
+    qDeleteAll(m_cnxs);
+}
+
+SqliteStorage::SqliteStorage() : Storage() { }
+
+SqliteStorage::~SqliteStorage() { }
+
+const QString SqliteStorage::getPath() {
+    return System::directory() + QString("/node.sqlite");
+}
+
+const QString SqliteStorage::type() const {
+    return "Sqlite";
+}
+
+/// @note A connection that fails to open isn't kept, so it's retried on the next access.
+SqliteStorage::Connection* SqliteStorage::connection() {
+    if (!s_cnxs.hasLocalData())
+        s_cnxs.setLocalData(new ConnectionSet);
+
+    QHash<QString, Connection*>& l_cnxs = s_cnxs.localData()->m_cnxs;
+    const QString l_pth = getPath();
+    const QHash<QString, Connection*>::ConstIterator l_itr = l_cnxs.constFind(l_pth);
+    if (l_itr != l_cnxs.constEnd())
+        return l_itr.value();
+
+    Connection* l_cnx = new Connection;
+    l_cnx->m_name = QString("wntrdata-sqlite-%1").arg(s_cnxCnt.fetchAndAddOrdered(1));
+
+    {
+        QSqlDatabase l_db = QSqlDatabase::addDatabase("QSQLITE", l_cnx->m_name);
+        l_db.setDatabaseName(l_pth);
+        l_db.setConnectOptions(QString("QSQLITE_BUSY_TIMEOUT=%1").arg(SQLITESTORAGE_BUSY_TIMEOUT));
+
+        if (!l_db.open()) {
+            qWarning() << "(data) [SqliteStorage] Can't open" << l_pth << ":" << l_db.lastError().text();
+            delete l_cnx;
+            return NULL;
+        }
+    }
+
+    for (int i = 0; SQLITESTORAGE_SCHEMA[i]; i++) {
+        if (!execute(l_cnx, SQLITESTORAGE_SCHEMA[i])) {
+            delete l_cnx;
+            return NULL;
+        }
+    }
+
+    for (int i = 0; i < StatementCount; i++) {
+        l_cnx->m_stmts[i] = new QSqlQuery(QSqlDatabase::database(l_cnx->m_name, false));
+        l_cnx->m_stmts[i]->setForwardOnly(true);
+
+        if (!l_cnx->m_stmts[i]->prepare(SQLITESTORAGE_STATEMENTS[i])) {
+            qWarning() << "(data) [SqliteStorage] Can't prepare" << SQLITESTORAGE_STATEMENTS[i] << ":" << l_cnx->m_stmts[i]->lastError().text();
+            delete l_cnx;
+            return NULL;
+        }
+    }
+
+    l_cnxs.insert(l_pth, l_cnx);
+    return l_cnx;
+}
+
+const bool SqliteStorage::execute(const Connection* p_cnx, const QString& p_sql) {
+    QSqlQuery l_qry(QSqlDatabase::database(p_cnx->m_name, false));
+    if (l_qry.exec(p_sql))
+        return true;
+
+    qWarning() << "(data) [SqliteStorage] Can't run" << p_sql << ":" << l_qry.lastError().text();
+    return false;
+}
+
+const QByteArray SqliteStorage::encodeFlags(const FlagList& p_flgs) {
+    QByteArray l_blob;
+    QDataStream l_strm(&l_blob, QIODevice::WriteOnly);
+    l_strm.setVersion(QDataStream::Qt_4_6);
+    l_strm << (quint16) p_flgs.count();
+    for (int i = 0; i < p_flgs.count(); i++)
+        l_strm << p_flgs.at(i).guid() << p_flgs.at(i).link();
+
+    return l_blob;
+}
+
+/// @note The flags were encoded from a sorted FlagList, so they come back sorted.
+const FlagList SqliteStorage::decodeFlags(const QByteArray& p_blob) {
+    FlagList l_flgs;
+    QDataStream l_strm(p_blob);
+    l_strm.setVersion(QDataStream::Qt_4_6);
+
+    quint16 l_cnt = 0;
+    l_strm >> l_cnt;
+    for (int i = 0; i < l_cnt; i++) {
+        QString l_guid, l_link;
+        l_strm >> l_guid >> l_link;
+        if (l_strm.status() != QDataStream::Ok)
+            break;
+
+        l_flgs.append(Flag(l_guid, l_link));
+    }
+
+    return l_flgs;
+}
+
+const bool SqliteStorage::exists(const Data& p_dt) const {
+    Connection* l_cnx = connection();
+    if (!l_cnx)
+        return false;
+
+    QSqlQuery* l_qry = l_cnx->m_stmts[StatementFind];
+    l_qry->bindValue(0, p_dt.locale());
+    l_qry->bindValue(1, toBlob(p_dt.nodeId()));
+    const bool l_fnd = l_qry->exec() && l_qry->next();
+    l_qry->finish();
+    return l_fnd;
+}
+
+const bool SqliteStorage::fill(const Connection* p_cnx, Data& p_dt) {
+    QSqlQuery* l_qry = p_cnx->m_stmts[StatementFind];
+    l_qry->bindValue(0, p_dt.locale());
+    l_qry->bindValue(1, toBlob(p_dt.nodeId()));
+
+    const bool l_fnd = l_qry->exec() && l_qry->next();
+    if (l_fnd) {
+        const Node& l_nd = p_dt.node();
+        const FlagList* l_flgs = FlagSets::intern(decodeFlags(l_qry->value(1).toByteArray()));
+        p_dt.setNode(Node(l_nd.nodeId(), l_nd.localeAtom(), l_qry->value(0).toString(), l_flgs));
+    }
+
+    l_qry->finish();
+    return l_fnd;
+}
+
+void SqliteStorage::loadTo(Data& p_dt) const {
+    Connection* l_cnx = connection();
+    if (l_cnx)
+        fill(l_cnx, p_dt);
+}
+
+void SqliteStorage::loadBatch(QList<Data>& p_nodes, QVector<bool>& p_fnd) const {
+    Connection* l_cnx = connection();
+    if (!l_cnx)
+        return;
+
+    // One read transaction keeps the batch consistent and spares a lock per lookup.
+    const bool l_txn = execute(l_cnx, "BEGIN");
+    for (int i = 0; i < p_nodes.count(); i++) {
+        if (!p_fnd.at(i) && fill(l_cnx, p_nodes[i]))
+            p_fnd[i] = true;
+    }
+
+    if (l_txn)
+        execute(l_cnx, "COMMIT");
+}
+
+void SqliteStorage::saveFrom(const Data& p_dt) {
+    QList<Data> l_nodes;
+    l_nodes << p_dt;
+    saveBatch(l_nodes, DurabilityFlush);
+}
+
+/// @note In WAL mode each durability maps onto a synchronous level for the batch: None to OFF (never synced),
+///       Flush to NORMAL (synced at checkpoints alone) and Sync to FULL (synced at every commit).
+const bool SqliteStorage::saveBatch(const QList<Data>& p_nodes, const Durability p_drblty) {
+    if (p_nodes.isEmpty())
+        return true;
+
+    Connection* l_cnx = connection();
+    if (!l_cnx)
+        return false;
+
+    if (p_drblty == DurabilitySync)
+        execute(l_cnx, "PRAGMA synchronous = FULL");
+    else if (p_drblty == DurabilityNone)
+        execute(l_cnx, "PRAGMA synchronous = OFF");
+
+    bool l_ok = execute(l_cnx, "BEGIN IMMEDIATE");
+    if (l_ok) {
+        QSqlQuery* l_qry = l_cnx->m_stmts[StatementLearn];
+
+        foreach (const Data& l_dt, p_nodes) {
+            if (l_dt.nodeId().isNull()) {
+                qWarning() << "(data) [SqliteStorage] Skipping node without an ID" << l_dt.symbol();
+                continue;
+            }
+
+            l_qry->bindValue(0, l_dt.locale());
+            l_qry->bindValue(1, toBlob(l_dt.nodeId()));
+            l_qry->bindValue(2, l_dt.symbol());
+            l_qry->bindValue(3, encodeFlags(l_dt.node().flagList()));
+
+            if (!l_qry->exec()) {
+                qWarning() << "(data) [SqliteStorage] Can't save" << l_dt.id() << ":" << l_qry->lastError().text();
+                l_ok = false;
+                break;
+            }
+        }
+
+        // The batch lands whole or not at all.
+        if (l_ok)
+            l_ok = execute(l_cnx, "COMMIT");
+
+        if (!l_ok)
+            execute(l_cnx, "ROLLBACK");
+    }
+
+    if (p_drblty != DurabilityFlush)
+        execute(l_cnx, "PRAGMA synchronous = NORMAL");
+
+    return l_ok;
+}
+
+const bool SqliteStorage::import(const QString& p_lcl) {
+    const QString l_pth = System::directory() + QString("/") + p_lcl + QString("/node.xml");
+    QFile l_file(l_pth);
+    if (!l_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "(data) [SqliteStorage] Can't access" << l_pth << ".";
+        return false;
+    }
+
+    Connection* l_cnx = connection();
+    if (!l_cnx)
+        return false;
+
+    QCryptographicHash l_md5(QCryptographicHash::Md5);
+    QByteArray l_blk;
+    while (!(l_blk = l_file.read(SQLITESTORAGE_READ_BLOCK)).isEmpty())
+        l_md5.addData(l_blk);
+
+    const QString l_dgst = QString(l_md5.result().toHex());
+    QSqlQuery l_qry(QSqlDatabase::database(l_cnx->m_name, false));
+    l_qry.setForwardOnly(true);
+
+    if (runQuery(l_qry, "SELECT digest FROM sources WHERE locale = ?", QVariantList() << p_lcl) && l_qry.next()
+            && l_qry.value(0).toString() == l_dgst) {
+        qDebug() << "(data) [SqliteStorage]" << l_pth << "is unchanged; skipping it.";
+        return false;
+    }
+
+    l_qry.finish();
+    l_file.seek(0);
+    qDebug() << "(data) [SqliteStorage] Importing" << l_pth << "...";
+
+    QStringList l_syms;
+    QList<const FlagList*> l_flgs;
+    NodeXmlReader l_rdr(&l_file);
+    QString l_sym;
+    QVariantMap l_mp;
+    while (l_rdr.next(l_sym, l_mp)) {
+        l_syms << l_sym;
+        l_flgs << FlagSets::intern(Node::toFlagList(l_mp));
+    }
+
+    // Unlike DomStorage, there's no DOM to fall back on; the last import's kept instead.
+    if (l_rdr.hasError()) {
+        qWarning() << "(data) [SqliteStorage] Can't stream" << l_pth << ":" << l_rdr.errorString() << "; keeping what was imported before.";
+        return false;
+    }
+
+    NodeIdList l_ids;
+    NodeId::fromSymbols(l_syms, l_ids);
+
+    if (!execute(l_cnx, "BEGIN IMMEDIATE"))
+        return false;
+
+    // Learned nodes aren't derived from node.xml, so they stay put and win over what's imported.
+    bool l_ok = runQuery(l_qry, "DELETE FROM nodes WHERE locale = ? AND learned = 0", QVariantList() << p_lcl)
+                && runQuery(l_qry, "DELETE FROM pseudos WHERE locale = ?", QVariantList() << p_lcl)
+                && runQuery(l_qry, "DELETE FROM suffixes WHERE locale = ?", QVariantList() << p_lcl);
+
+    if (l_ok && l_qry.prepare("INSERT OR IGNORE INTO nodes (locale, id, symbol, flags) VALUES (?, ?, ?, ?)")) {
+        // Nodes share their flag sets, so each set's encoded once.
+        QHash<const FlagList*, QByteArray> l_blobs;
+
+        // Only the last definition of a symbol counts, so they're inserted last to first.
+        for (int i = l_ids.count() - 1; l_ok && i >= 0; i--) {
+            QHash<const FlagList*, QByteArray>::ConstIterator l_itr = l_blobs.constFind(l_flgs.at(i));
+            if (l_itr == l_blobs.constEnd())
+                l_itr = l_blobs.insert(l_flgs.at(i), encodeFlags(*l_flgs.at(i)));
+
+            l_qry.addBindValue(p_lcl);
+            l_qry.addBindValue(toBlob(l_ids.at(i)));
+            l_qry.addBindValue(l_syms.at(i));
+            l_qry.addBindValue(l_itr.value());
+
+            if (!l_qry.exec()) {
+                qWarning() << "(data) [SqliteStorage] Can't import" << l_syms.at(i) << ":" << l_qry.lastError().text();
+                l_ok = false;
+            }
+        }
+    } else
+        l_ok = false;
+
+    if (l_ok && l_rdr.hasPseudo())
+        l_ok = runQuery(l_qry, "INSERT INTO pseudos (locale, flags) VALUES (?, ?)",
+                        QVariantList() << p_lcl << encodeFlags(Node::toFlagList(l_rdr.pseudoFlags())));
+
+    const QHash<QString, QString> l_sfxs = l_rdr.suffixes();
+    for (QHash<QString, QString>::ConstIterator l_itr = l_sfxs.constBegin(); l_ok && l_itr != l_sfxs.constEnd(); ++l_itr)
+        l_ok = runQuery(l_qry, "INSERT INTO suffixes (locale, suffix, full) VALUES (?, ?, ?)",
+                        QVariantList() << p_lcl << l_itr.key() << l_itr.value());
+
+    if (l_ok)
+        l_ok = runQuery(l_qry, "INSERT OR REPLACE INTO sources (locale, digest) VALUES (?, ?)", QVariantList() << p_lcl << l_dgst);
+
+    l_qry.finish();
+
+    // The locale's swapped over whole, or left as it was.
+    if (!l_ok || !execute(l_cnx, "COMMIT")) {
+        execute(l_cnx, "ROLLBACK");
+        return false;
+    }
+
+    qDebug() << "(data) [SqliteStorage] Imported" << l_ids.count() << "nodes of" << p_lcl << ".";
+    return true;
+}
+
+void SqliteStorage::generate() {
+    foreach (const QString l_lcl, System::locales()) {
+        if (QFile::exists(System::directory() + QString("/") + l_lcl + QString("/node.xml")))
+            import(l_lcl);
+    }
+}
+
+const bool SqliteStorage::prepare(const QString& p_lcl) {
+    return import(p_lcl);
+}
+
+const bool SqliteStorage::hasPseudo(const Data& p_dt) const {
+    Connection* l_cnx = connection();
+    if (!l_cnx)
+        return false;
+
+    QSqlQuery* l_qry = l_cnx->m_stmts[StatementPseudo];
+    l_qry->bindValue(0, p_dt.locale());
+    const bool l_fnd = l_qry->exec() && l_qry->next();
+    l_qry->finish();
+    return l_fnd;
+}
+
+void SqliteStorage::loadPseudo(Data& p_dt) const {
+    Connection* l_cnx = connection();
+    if (!l_cnx)
+        return;
+
+    QSqlQuery* l_qry = l_cnx->m_stmts[StatementPseudo];
+    l_qry->bindValue(0, p_dt.locale());
+
+    if (l_qry->exec() && l_qry->next()) {
+        const FlagList l_flgs = decodeFlags(l_qry->value(0).toByteArray());
+        QVariantMap l_mp;
+        for (int i = 0; i < l_flgs.count(); i++)
+            l_mp.insert(l_flgs.at(i).guid(), l_flgs.at(i).link());
+
+        // Only the flags are taken from the pseudo node; the symbol (and thus the ID) stays put.
+        const QString l_sym = p_dt.symbol();
+        p_dt.setFlags(l_mp);
+        p_dt.setSymbol(l_sym);
+    }
+
+    l_qry->finish();
+}
+
+const QString SqliteStorage::obtainFullSuffix(const QString& p_lcl, const QString& p_sfx) const {
+    Connection* l_cnx = connection();
+    if (!l_cnx)
+        return "";
+
+    QSqlQuery* l_qry = l_cnx->m_stmts[StatementSuffix];
+    l_qry->bindValue(0, p_lcl);
+    l_qry->bindValue(1, p_sfx);
+    const QString l_full = (l_qry->exec() && l_qry->next()) ? l_qry->value(0).toString() : QString("");
+    l_qry->finish();
+    return l_full;
+}
+
+const bool SqliteStorage::nodes(const QString& p_lcl, NodeIdList& p_ids) const {
+    Connection* l_cnx = connection();
+    if (!l_cnx)
+        return false;
+
+    QSqlQuery* l_qry = l_cnx->m_stmts[StatementNodes];
+    l_qry->bindValue(0, p_lcl);
+    if (!l_qry->exec())
+        return false;
+
+    while (l_qry->next()) {
+        const QByteArray l_blob = l_qry->value(0).toByteArray();
+        if (l_blob.size() == 16)
+            p_ids << NodeId::fromBytes((const uchar*) l_blob.constData());
+    }
+
+    l_qry->finish();
+    return true;
+}
+
+const bool SqliteStorage::isJournaled() const {
+    return true;
+}
+
+/// @note The null ID's sixteen zero bytes sort before every real ID, so it pages from the beginning as is.
+const bool SqliteStorage::scan(const QString& p_lcl, const NodeId& p_aftr, const int p_lmt, NodeIdList& p_ids) const {
+    Connection* l_cnx = connection();
+    if (!l_cnx)
+        return false;
+
+    QSqlQuery* l_qry = l_cnx->m_stmts[StatementScan];
+    l_qry->bindValue(0, p_lcl);
+    l_qry->bindValue(1, toBlob(p_aftr));
+    l_qry->bindValue(2, p_lmt);
+    if (!l_qry->exec())
+        return false;
+
+    while (l_qry->next()) {
+        const QByteArray l_blob = l_qry->value(0).toByteArray();
+        if (l_blob.size() == 16)
+            p_ids << NodeId::fromBytes((const uchar*) l_blob.constData());
+    }
+
+    l_qry->finish();
+    return true;
+}
+
+}
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
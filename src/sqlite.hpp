@@ -0,0 +1,206 @@
+/**
+ * @file sqlite.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef SQLITE_HPP
+#define SQLITE_HPP
+
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+#include <QAtomicInt>
+#include <QThreadStorage>
+#include "lexical.hpp"
+
+class QSqlQuery;
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct SqliteStorage;
+
+/**
+ * @brief Represents a Storage kept in a single SQLite database.
+ *
+ * Every locale's held in <tt>node.sqlite</tt> at the root of the linguistics
+ * directory, as follows:
+ *
+ * @code
+ * nodes    : locale, id (the raw 16-byte ID), symbol, flags, learned
+ * pseudos  : locale, flags
+ * suffixes : locale, suffix, full
+ * sources  : locale, digest (the MD5 of the node.xml last imported)
+ * @endcode
+ *
+ * Flags are kept as a blob: a quint16 count followed by each GUID and link
+ * code in QDataStream format. generate() and prepare() import a locale's
+ * node.xml in a single transaction, unless its digest is unchanged; nodes
+ * written through saveFrom() are marked as learned and survive imports.
+ *
+ * The database is opened in WAL mode, so readers never wait on a writer.
+ * QtSql connections can't be shared between threads, so each thread opens
+ * its own, along with its prepared statements, the first time it touches
+ * the database; they're closed when the thread exits.
+ *
+ * @class SqliteStorage sqlite.hpp "src/sqlite.hpp"
+ */
+class SqliteStorage : public Storage {
+    /**
+     * @brief The statements prepared on every connection.
+     */
+    enum Statement {
+        StatementFind = 0,
+        StatementLearn,
+        StatementPseudo,
+        StatementSuffix,
+        StatementNodes,
+        StatementScan,
+        StatementCount
+    };
+
+    /**
+     * @brief A thread's connection to a database, and its prepared statements.
+     */
+    struct Connection {
+        Connection();
+        ~Connection();
+        QString m_name; /**< The name the connection's registered under with QSqlDatabase. */
+        QSqlQuery* m_stmts[StatementCount]; /**< The prepared statements; null if the connection failed. */
+    };
+
+    /**
+     * @brief A thread's connections, keyed by the path of their database; they're closed along with it.
+     */
+    struct ConnectionSet {
+        ~ConnectionSet();
+        QHash<QString, Connection*> m_cnxs;
+    };
+
+private:
+    static QThreadStorage<ConnectionSet*> s_cnxs; /**< Each thread's connections. */
+    static QAtomicInt s_cnxCnt; /**< The number of connections ever opened; it names them. */
+
+    /**
+     * @brief Obtains the calling thread's connection to the current database, opening it if needed.
+     * @fn connection
+     * @return The connection, or NULL if the database can't be opened.
+     */
+    static Connection* connection();
+
+    /**
+     * @brief Imports a locale's node.xml, unless it's unchanged since the last import.
+     * @fn import
+     * @param p_lcl The locale in question.
+     * @return true if the locale's nodes were imported anew.
+     */
+    static const bool import(const QString& );
+
+    /**
+     * @brief Runs a statement that isn't worth keeping prepared.
+     * @fn execute
+     * @param p_cnx The connection to run it on.
+     * @param p_sql The statement in question.
+     */
+    static const bool execute(const Connection*, const QString& );
+
+    /**
+     * @brief Fills a Data from its row, if there's one.
+     * @fn fill
+     * @param p_cnx The connection to look it up on.
+     * @param p_dt The Data to fill.
+     * @return true if the node's held here.
+     */
+    static const bool fill(const Connection*, Data& );
+
+    static const QByteArray encodeFlags(const FlagList& );
+    static const FlagList decodeFlags(const QByteArray& );
+
+public:
+    /**
+     * @brief Null constructor.
+     * @fn SqliteStorage
+     */
+    SqliteStorage();
+
+    /**
+     * @brief Deconstructor.
+     * @fn ~SqliteStorage
+     * @note Connections belong to their threads, not to the storage, so they outlive it.
+     */
+    virtual ~SqliteStorage();
+
+    /**
+     * @brief Obtains the path of the database.
+     * @fn getPath
+     */
+    static const QString getPath();
+
+    virtual const QString type() const;
+    virtual const bool exists(const Data& ) const;
+    virtual void loadTo(Data& ) const;
+    virtual void saveFrom(const Data& );
+
+    /**
+     * @brief Saves a batch of nodes in a single transaction.
+     * @fn saveBatch
+     * @param p_nodes The nodes to be saved.
+     * @param p_drblty How hard the batch is pushed to disk; DurabilitySync waits on the disk itself, DurabilityNone never syncs.
+     * @return false if the transaction was rolled back.
+     */
+    virtual const bool saveBatch(const QList<Data>&, const Durability = DurabilityFlush);
+
+    /**
+     * @brief Loads a batch of nodes within a single read transaction.
+     * @fn loadBatch
+     * @param p_nodes The nodes to be filled.
+     * @param p_fnd Which of the nodes have been found so far.
+     */
+    virtual void loadBatch(QList<Data>&, QVector<bool>& ) const;
+
+    /**
+     * @brief Imports the node.xml of every locale that changed since it was last imported.
+     * @fn generate
+     */
+    virtual void generate();
+
+    virtual const bool hasPseudo(const Data& ) const;
+    virtual void loadPseudo(Data& ) const;
+    virtual const QString obtainFullSuffix(const QString&, const QString& ) const;
+    virtual const bool nodes(const QString&, NodeIdList& ) const;
+    virtual const bool isJournaled() const;
+    virtual const bool scan(const QString&, const NodeId&, const int, NodeIdList& ) const;
+
+    /**
+     * @brief Imports the node.xml of a single locale, unless it's unchanged.
+     * @fn prepare
+     * @param p_lcl The locale in question.
+     */
+    virtual const bool prepare(const QString& );
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
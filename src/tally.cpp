@@ -0,0 +1,206 @@
+/**
+ * @file tally.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include "tally.hpp"
+#include "lexical.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+
+static void appendHistogram(QTextStream& p_strm, const QString& p_nm, const QVector<int>& p_hst) {
+    p_strm << p_nm;
+    foreach (const int l_cnt, p_hst)
+        p_strm << " " << l_cnt;
+
+    p_strm << endl;
+}
+
+static const bool readHistogram(const QStringList& p_flds, QVector<int>& p_hst) {
+    if (p_flds.count () != p_hst.count () + 1)
+        return false;
+
+    for (int i = 0; i < p_hst.count (); i++) {
+        bool l_ok = false;
+        p_hst[i] = p_flds.at (i + 1).toInt (&l_ok);
+        if (!l_ok)
+            return false;
+    }
+
+    return true;
+}
+
+static QVariantList toList(const QVector<int>& p_hst) {
+    QVariantList l_lst;
+    foreach (const int l_cnt, p_hst)
+        l_lst << l_cnt;
+
+    return l_lst;
+}
+
+Tally::Tally() : m_nodes(0), m_flgs(0), m_flgHst(FlagBuckets, 0), m_symHst(SymbolBuckets, 0), m_chngs(0) { }
+
+void Tally::add(const Node& p_nd) {
+    const int l_flgs = p_nd.flagCount ();
+    m_nodes++;
+    m_flgs += l_flgs;
+    m_flgHst[qMin(l_flgs, FlagBuckets - 1)]++;
+    m_symHst[qMin(p_nd.symbol ().length (), SymbolBuckets - 1)]++;
+    m_chngs++;
+}
+
+/// @note Counts never drop below zero, so a tally that's drifted can't go negative.
+void Tally::remove(const Node& p_nd) {
+    const int l_flgs = p_nd.flagCount ();
+    int& l_flgBkt = m_flgHst[qMin(l_flgs, FlagBuckets - 1)];
+    int& l_symBkt = m_symHst[qMin(p_nd.symbol ().length (), SymbolBuckets - 1)];
+
+    m_nodes = qMax(m_nodes - 1, 0);
+    m_flgs = qMax(m_flgs - l_flgs, (qint64) 0);
+    l_flgBkt = qMax(l_flgBkt - 1, 0);
+    l_symBkt = qMax(l_symBkt - 1, 0);
+    m_chngs++;
+}
+
+const int Tally::nodes() const {
+    return m_nodes;
+}
+
+const qint64 Tally::flags() const {
+    return m_flgs;
+}
+
+const QVector<int>& Tally::flagHistogram() const {
+    return m_flgHst;
+}
+
+const QVector<int>& Tally::symbolHistogram() const {
+    return m_symHst;
+}
+
+const int Tally::changes() const {
+    return m_chngs;
+}
+
+const QVariantMap Tally::toMap() const {
+    QVariantMap l_map;
+    l_map["Nodes"] = m_nodes;
+    l_map["Flags"] = m_flgs;
+    l_map["FlagsPerNode"] = toList(m_flgHst);
+    l_map["SymbolLength"] = toList(m_symHst);
+    return l_map;
+}
+
+const QString Tally::getPath(const QString& p_lcl) {
+    return System::directory () + QString("/") + p_lcl + QString("/node.tally");
+}
+
+const bool Tally::save(const QString& p_pth) {
+    const QString l_tmpPth = p_pth + ".tmp";
+    QFile l_file(l_tmpPth);
+    if (!l_file.open (QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "(data) [Tally] Can't write" << l_tmpPth << ":" << l_file.errorString ();
+        return false;
+    }
+
+    QTextStream l_strm(&l_file);
+    l_strm << "# Generated" << endl << "nodes " << m_nodes << endl << "flags " << m_flgs << endl;
+    appendHistogram(l_strm, "flagsPerNode", m_flgHst);
+    appendHistogram(l_strm, "symbolLength", m_symHst);
+    l_strm.flush ();
+    l_file.close ();
+
+    QFile::remove (p_pth);
+    if (!QFile::rename (l_tmpPth, p_pth)) {
+        qWarning() << "(data) [Tally] Can't move tally into" << p_pth << ".";
+        return false;
+    }
+
+    QFile::remove (p_pth + ".dirty");
+    m_chngs = 0;
+    return true;
+}
+
+void Tally::markDirty(const QString& p_pth) {
+    const QString l_mrkPth = p_pth + ".dirty";
+    if (QFile::exists (l_mrkPth))
+        return;
+
+    QFile l_file(l_mrkPth);
+    if (!l_file.open (QIODevice::WriteOnly))
+        qWarning() << "(data) [Tally] Can't mark" << p_pth << "as dirty:" << l_file.errorString ();
+}
+
+const bool Tally::isDirty(const QString& p_pth) {
+    return QFile::exists (p_pth + ".dirty");
+}
+
+const bool Tally::load(const QString& p_pth, Tally& p_tll) {
+    QFile l_file(p_pth);
+    if (!l_file.open (QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    Tally l_tll;
+    int l_fnd = 0;
+    QTextStream l_strm(&l_file);
+    while (!l_strm.atEnd ()) {
+        const QStringList l_flds = l_strm.readLine ().split (" ", QString::SkipEmptyParts);
+        if (l_flds.count () < 2)
+            continue;
+
+        bool l_ok = true;
+        if (l_flds.at (0) == "nodes")
+            l_tll.m_nodes = l_flds.at (1).toInt (&l_ok);
+        else if (l_flds.at (0) == "flags")
+            l_tll.m_flgs = l_flds.at (1).toLongLong (&l_ok);
+        else if (l_flds.at (0) == "flagsPerNode")
+            l_ok = readHistogram(l_flds, l_tll.m_flgHst);
+        else if (l_flds.at (0) == "symbolLength")
+            l_ok = readHistogram(l_flds, l_tll.m_symHst);
+        else
+            continue;
+
+        if (!l_ok) {
+            qWarning() << "(data) [Tally] Malformed tally" << p_pth << "; ignoring it.";
+            return false;
+        }
+
+        l_fnd++;
+    }
+
+    if (l_fnd != 4)
+        return false;
+
+    l_tll.m_chngs = 0;
+    p_tll = l_tll;
+    return true;
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
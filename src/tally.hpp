@@ -0,0 +1,162 @@
+/**
+ * @file tally.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef TALLY_HPP
+#define TALLY_HPP
+
+#include <QString>
+#include <QVector>
+#include <QVariantMap>
+#include "node.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct Tally;
+
+/**
+ * @brief Running counts over the nodes of a locale.
+ *
+ * A Tally keeps the number of nodes and flags of a locale along with
+ * histograms of the flags per node and of the symbol lengths. It's built
+ * once when the lexicon's generated and then nudged with every write,
+ * so reading any of its figures never touches the storages.
+ *
+ * The last bucket of each histogram also holds everything past it.
+ *
+ * @class Tally tally.hpp "src/tally.hpp"
+ */
+class Tally {
+private:
+    int m_nodes;
+    qint64 m_flgs;
+    QVector<int> m_flgHst;
+    QVector<int> m_symHst;
+    int m_chngs;
+
+public:
+    enum {
+        FlagBuckets = 33,   /**< Buckets for 0 to 31 flags, then 32 or more. */
+        SymbolBuckets = 65  /**< Buckets for 0 to 63 characters, then 64 or more. */
+    };
+
+    /**
+     * @brief Null constructor; an empty tally.
+     * @fn Tally
+     */
+    Tally();
+
+    /**
+     * @brief Counts a node in.
+     * @fn add
+     * @param p_nd The node in question.
+     */
+    void add(const Node& );
+
+    /**
+     * @brief Counts a node out.
+     * @fn remove
+     * @param p_nd The node in question, as it was counted in.
+     */
+    void remove(const Node& );
+
+    /**
+     * @brief Obtains the number of nodes counted.
+     * @fn nodes
+     */
+    const int nodes() const;
+
+    /**
+     * @brief Obtains the number of flags across every node counted.
+     * @fn flags
+     */
+    const qint64 flags() const;
+
+    /**
+     * @brief Obtains the histogram of flags per node.
+     * @fn flagHistogram
+     */
+    const QVector<int>& flagHistogram() const;
+
+    /**
+     * @brief Obtains the histogram of symbol lengths.
+     * @fn symbolHistogram
+     */
+    const QVector<int>& symbolHistogram() const;
+
+    /**
+     * @brief Obtains the number of changes made since the tally was last saved or loaded.
+     * @fn changes
+     */
+    const int changes() const;
+
+    /**
+     * @brief Represents the tally as a map (i.e.: for D-Bus).
+     * @fn toMap
+     */
+    const QVariantMap toMap() const;
+
+    /**
+     * @brief Saves the tally to disk, clearing its dirty marker.
+     * @fn save
+     * @param p_pth The path to save the tally to.
+     */
+    const bool save(const QString& );
+
+    /**
+     * @brief Marks the tally on disk as behind the nodes, until it's next saved.
+     * @fn markDirty
+     * @param p_pth The path of the tally in question.
+     */
+    static void markDirty(const QString& );
+
+    /**
+     * @brief Determines whether the tally on disk may be behind the nodes (i.e.: after a crash).
+     * @fn isDirty
+     * @param p_pth The path of the tally in question.
+     */
+    static const bool isDirty(const QString& );
+
+    /**
+     * @brief Loads a tally from disk.
+     * @fn load
+     * @param p_pth The path to load the tally from.
+     * @param p_tll The tally to fill.
+     */
+    static const bool load(const QString&, Tally& );
+
+    /**
+     * @brief Obtains the path of the tally for the specified locale.
+     * @fn getPath
+     * @param p_lcl The locale in question.
+     */
+    static const QString getPath(const QString& );
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
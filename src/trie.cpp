@@ -0,0 +1,256 @@
+/**
+ * @file trie.cpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#include "trie.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+
+SymbolTrie::SymbolTrie() : m_vrts(), m_cnt(0) {
+    Vertex l_root;
+    l_root.m_term = false;
+    m_vrts << l_root;
+}
+
+const QString SymbolTrie::keyOf(const QString& p_sym) {
+    return p_sym.toLower();
+}
+
+/// @note The children are sorted by the first character of their edge, and no two share one.
+const int SymbolTrie::lowerBound(const int p_vrt, const QChar& p_chr) const {
+    const QVector<int>& l_kids = m_vrts.at(p_vrt).m_kids;
+    int l_lo = 0, l_hi = l_kids.count();
+    while (l_lo < l_hi) {
+        const int l_mid = (l_lo + l_hi) / 2;
+        if (m_vrts.at(l_kids.at(l_mid)).m_lbl.at(0) < p_chr)
+            l_lo = l_mid + 1;
+        else
+            l_hi = l_mid;
+    }
+
+    return l_lo;
+}
+
+const int SymbolTrie::child(const int p_vrt, const QChar& p_chr) const {
+    const QVector<int>& l_kids = m_vrts.at(p_vrt).m_kids;
+    const int l_indx = lowerBound(p_vrt, p_chr);
+    if (l_indx < l_kids.count() && m_vrts.at(l_kids.at(l_indx)).m_lbl.at(0) == p_chr)
+        return l_kids.at(l_indx);
+
+    return -1;
+}
+
+void SymbolTrie::insert(const QString& p_sym, const NodeId& p_id) {
+    const QString l_key = keyOf(p_sym);
+    int l_vrt = 0, l_pos = 0;
+
+    forever {
+        if (l_pos == l_key.length()) {
+            Vertex& l_end = m_vrts[l_vrt];
+            if (!l_end.m_term)
+                m_cnt++;
+
+            l_end.m_term = true;
+            l_end.m_id = p_id;
+            return;
+        }
+
+        int l_kid = child(l_vrt, l_key.at(l_pos));
+        if (l_kid == -1) {
+            Vertex l_leaf;
+            l_leaf.m_lbl = l_key.mid(l_pos);
+            l_leaf.m_id = p_id;
+            l_leaf.m_term = true;
+            m_vrts << l_leaf;
+
+            const int l_indx = lowerBound(l_vrt, l_key.at(l_pos));
+            m_vrts[l_vrt].m_kids.insert(l_indx, m_vrts.count() - 1);
+            m_cnt++;
+            return;
+        }
+
+        const QString l_lbl = m_vrts.at(l_kid).m_lbl;
+        int l_cmn = 1;
+        while (l_cmn < l_lbl.length() && l_pos + l_cmn < l_key.length() && l_lbl.at(l_cmn) == l_key.at(l_pos + l_cmn))
+            l_cmn++;
+
+        // The key parts from the edge midway; split it so that the shared run gets its own vertex.
+        if (l_cmn < l_lbl.length()) {
+            Vertex l_mid;
+            l_mid.m_lbl = l_lbl.left(l_cmn);
+            l_mid.m_kids << l_kid;
+            l_mid.m_term = false;
+            m_vrts[l_kid].m_lbl = l_lbl.mid(l_cmn);
+            m_vrts << l_mid;
+
+            // The split vertex starts with the same character, so the children stay sorted.
+            QVector<int>& l_kids = m_vrts[l_vrt].m_kids;
+            l_kids[l_kids.indexOf(l_kid)] = m_vrts.count() - 1;
+            l_kid = m_vrts.count() - 1;
+        }
+
+        l_vrt = l_kid;
+        l_pos += l_cmn;
+    }
+}
+
+const NodeId SymbolTrie::find(const QString& p_sym) const {
+    const QString l_key = keyOf(p_sym);
+    int l_vrt = 0, l_pos = 0;
+
+    while (l_pos < l_key.length()) {
+        const int l_kid = child(l_vrt, l_key.at(l_pos));
+        if (l_kid == -1)
+            return NodeId();
+
+        const QString& l_lbl = m_vrts.at(l_kid).m_lbl;
+        if (l_key.mid(l_pos, l_lbl.length()) != l_lbl)
+            return NodeId();
+
+        l_vrt = l_kid;
+        l_pos += l_lbl.length();
+    }
+
+    const Vertex& l_end = m_vrts.at(l_vrt);
+    return l_end.m_term ? l_end.m_id : NodeId();
+}
+
+const bool SymbolTrie::remove(const QString& p_sym) {
+    const QString l_key = keyOf(p_sym);
+    int l_vrt = 0, l_pos = 0;
+
+    while (l_pos < l_key.length()) {
+        const int l_kid = child(l_vrt, l_key.at(l_pos));
+        if (l_kid == -1)
+            return false;
+
+        const QString& l_lbl = m_vrts.at(l_kid).m_lbl;
+        if (l_key.mid(l_pos, l_lbl.length()) != l_lbl)
+            return false;
+
+        l_vrt = l_kid;
+        l_pos += l_lbl.length();
+    }
+
+    Vertex& l_end = m_vrts[l_vrt];
+    if (!l_end.m_term)
+        return false;
+
+    l_end.m_term = false;
+    l_end.m_id = NodeId();
+    m_cnt--;
+    return true;
+}
+
+/// @return false once p_lmt entries have been gathered, which calls off the rest of the walk.
+const bool SymbolTrie::collect(const int p_vrt, const QString& p_pth, const int p_lmt, EntryList& p_out) const {
+    const Vertex& l_vrt = m_vrts.at(p_vrt);
+    if (l_vrt.m_term) {
+        p_out << qMakePair(p_pth, l_vrt.m_id);
+        if (p_out.count() >= p_lmt)
+            return false;
+    }
+
+    foreach (const int l_kid, l_vrt.m_kids) {
+        if (!collect(l_kid, p_pth + m_vrts.at(l_kid).m_lbl, p_lmt, p_out))
+            return false;
+    }
+
+    return true;
+}
+
+const bool SymbolTrie::collectRange(const int p_vrt, const QString& p_pth, const QString& p_frm, const QString& p_to, const int p_lmt, EntryList& p_out) const {
+    // The walk's in sorted order, so everything from here on sorts past the upper bound too.
+    if (!p_to.isEmpty() && !(p_pth < p_to))
+        return false;
+
+    // Every symbol below a path that sorts before the lower bound (and doesn't lead to it) does as well.
+    if (p_pth < p_frm && !p_frm.startsWith(p_pth))
+        return true;
+
+    const Vertex& l_vrt = m_vrts.at(p_vrt);
+    if (l_vrt.m_term && !(p_pth < p_frm)) {
+        p_out << qMakePair(p_pth, l_vrt.m_id);
+        if (p_out.count() >= p_lmt)
+            return false;
+    }
+
+    foreach (const int l_kid, l_vrt.m_kids) {
+        if (!collectRange(l_kid, p_pth + m_vrts.at(l_kid).m_lbl, p_frm, p_to, p_lmt, p_out))
+            return false;
+    }
+
+    return true;
+}
+
+const SymbolTrie::EntryList SymbolTrie::prefix(const QString& p_pfx, const int p_lmt) const {
+    EntryList l_out;
+    if (p_lmt <= 0)
+        return l_out;
+
+    // Walk down to the vertex the prefix ends on (or ends within the edge of).
+    const QString l_pfx = keyOf(p_pfx);
+    QString l_pth;
+    int l_vrt = 0, l_pos = 0;
+
+    while (l_pos < l_pfx.length()) {
+        const int l_kid = child(l_vrt, l_pfx.at(l_pos));
+        if (l_kid == -1)
+            return l_out;
+
+        const QString& l_lbl = m_vrts.at(l_kid).m_lbl;
+        const int l_len = qMin(l_lbl.length(), l_pfx.length() - l_pos);
+        if (l_lbl.left(l_len) != l_pfx.mid(l_pos, l_len))
+            return l_out;
+
+        l_pth += l_lbl;
+        l_pos += l_len;
+        l_vrt = l_kid;
+    }
+
+    collect(l_vrt, l_pth, p_lmt, l_out);
+    return l_out;
+}
+
+const SymbolTrie::EntryList SymbolTrie::range(const QString& p_frm, const QString& p_to, const int p_lmt) const {
+    EntryList l_out;
+    if (p_lmt > 0)
+        collectRange(0, QString(), keyOf(p_frm), keyOf(p_to), p_lmt, l_out);
+
+    return l_out;
+}
+
+const int SymbolTrie::count() const {
+    return m_cnt;
+}
+
+const int SymbolTrie::vertices() const {
+    return m_vrts.count();
+}
+
+} /** end namespace Lexical */
+}
+}
+}
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,149 @@
+/**
+ * @file trie.hpp
+ * @author Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ *
+ * @legalese
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ * @endlegalese
+ */
+
+#ifndef TRIE_HPP
+#define TRIE_HPP
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include "node.hpp"
+
+namespace Wintermute {
+namespace Data {
+namespace Linguistics {
+namespace Lexical {
+struct SymbolTrie;
+
+/**
+ * @brief A compressed (radix) trie over the symbols of a locale.
+ *
+ * Each edge carries a run of characters rather than a single one, so a
+ * chain of single-child nodes collapses into one. Symbols are keyed in
+ * lower case, just as they're hashed into node IDs, and each one leads
+ * to the ID of its node.
+ *
+ * The children of a node are kept sorted by the first character of their
+ * edge, so walking the trie depth-first visits the symbols in the same
+ * order QString sorts them; prefix and range queries stop as soon as
+ * they've gathered enough.
+ *
+ * @class SymbolTrie trie.hpp "src/trie.hpp"
+ */
+class SymbolTrie {
+public:
+    typedef QPair<QString, NodeId> Entry; /**< A symbol (in lower case) and the ID of its node. */
+    typedef QList<Entry> EntryList;
+
+private:
+    struct Vertex {
+        QString m_lbl;
+        QVector<int> m_kids;
+        NodeId m_id;
+        bool m_term;
+    };
+
+    QVector<Vertex> m_vrts;
+    int m_cnt;
+
+    const int lowerBound(const int, const QChar& ) const;
+    const int child(const int, const QChar& ) const;
+    const bool collect(const int, const QString&, const int, EntryList& ) const;
+    const bool collectRange(const int, const QString&, const QString&, const QString&, const int, EntryList& ) const;
+
+public:
+    /**
+     * @brief Null constructor; an empty trie.
+     * @fn SymbolTrie
+     */
+    SymbolTrie();
+
+    /**
+     * @brief Maps a symbol to the ID of its node, replacing any earlier mapping.
+     * @fn insert
+     * @param p_sym The symbol in question.
+     * @param p_id The ID of its node.
+     */
+    void insert(const QString&, const NodeId& );
+
+    /**
+     * @brief Drops the mapping of a symbol.
+     * @fn remove
+     * @param p_sym The symbol in question.
+     * @return false if the symbol wasn't mapped.
+     * @note The vertices are left in place; they're reclaimed on the next rebuild.
+     */
+    const bool remove(const QString& );
+
+    /**
+     * @brief Obtains the ID mapped to a symbol.
+     * @fn find
+     * @param p_sym The symbol in question.
+     * @return The ID, or the null ID if the symbol isn't mapped.
+     */
+    const NodeId find(const QString& ) const;
+
+    /**
+     * @brief Lists the symbols starting with a prefix, in sorted order.
+     * @fn prefix
+     * @param p_pfx The prefix; an empty one lists every symbol.
+     * @param p_lmt The most symbols to list.
+     */
+    const EntryList prefix(const QString&, const int ) const;
+
+    /**
+     * @brief Lists the symbols within a range, in sorted order.
+     * @fn range
+     * @param p_frm The lower bound, inclusive.
+     * @param p_to The upper bound, exclusive; an empty one leaves the range open.
+     * @param p_lmt The most symbols to list.
+     */
+    const EntryList range(const QString&, const QString&, const int ) const;
+
+    /**
+     * @brief Obtains the number of symbols mapped.
+     * @fn count
+     */
+    const int count() const;
+
+    /**
+     * @brief Obtains the number of vertices held, including the root.
+     * @fn vertices
+     */
+    const int vertices() const;
+
+    /**
+     * @brief Normalizes a symbol into the form it's keyed by.
+     * @fn keyOf
+     * @param p_sym The symbol in question.
+     */
+    static const QString keyOf(const QString& );
+};
+
+}
+}
+}
+}
+
+#endif
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
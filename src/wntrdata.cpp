@@ -20,6 +20,8 @@
 
 #include <QtDebug>
 #include <QtPlugin>
+#include <QFile>
+#include <QRunnable>
 #include <wntr/core.hpp>
 #include <wntr/ipc.hpp>
 #include "wntrdata.hpp"
@@ -31,6 +33,26 @@ System* System::s_inst = NULL;
 NodeManager* NodeManager::s_inst = NULL;
 RuleManager* RuleManager::s_inst = NULL;
 
+/// @note Editors tend to write a file in a few goes; a reload waits for them to settle.
+static const int SYSTEM_RELOAD_DELAY = 1000;
+
+/**
+ * @brief Rebuilds the lexicon off the calling thread, then watches the new one's files.
+ * @class ReloadTask wntrdata.cpp "src/wntrdata.cpp"
+ */
+class ReloadTask : public QRunnable {
+private:
+    const QString m_dir;
+
+public:
+    explicit ReloadTask(const QString& p_dir = QString()) : QRunnable(), m_dir(p_dir) { }
+
+    virtual void run() {
+        Linguistics::System::reload (m_dir);
+        QMetaObject::invokeMethod (System::instance (),"watch",Qt::QueuedConnection);
+    }
+};
+
 RuleManager::RuleManager() : QObject(System::instance()) { }
 
 const bool RuleManager::exists(const QString &p_1, const QString &p_2) const {
@@ -45,6 +67,10 @@ void RuleManager::write(Rules::Chain &p_chn) {
     Rules::Cache::write(p_chn);
 }
 
+const QFuture<Rules::Chain> RuleManager::readAsync(const Rules::Chain &p_chn) const {
+    return Rules::Cache::readAsync(p_chn);
+}
+
 RuleManager* RuleManager::instance() {
     if (!s_inst) s_inst = new RuleManager;
     return s_inst;
@@ -61,18 +87,45 @@ Lexical::Data& NodeManager::pseudo(Lexical::Data &p_dt) const {
     return p_dt;
 }
 
-/// @todo Should this return a pseudo node of the passed data if the said node doesn't exist?
-Lexical::Data& NodeManager::read(Lexical::Data &p_dt) const {
-    if (!Lexical::Cache::read(p_dt))
+/// @note With p_dist above zero, a miss is first answered with the nearest symbol within that edit distance; the pseudo node's only the last resort.
+Lexical::Data& NodeManager::read(Lexical::Data &p_dt, const int p_dist) const {
+    if (!Lexical::Cache::read(p_dt) && !Lexical::Cache::approximate(p_dt, p_dist))
         Lexical::Cache::pseudo(p_dt);
     return p_dt;
 }
 
+static const Lexical::Data resolveNode(const Lexical::Data &p_dt) {
+    Lexical::Data l_dt(p_dt);
+    NodeManager::instance()->read(l_dt);
+    return l_dt;
+}
+
+/// @note Like read(), a miss is answered with the pseudo node.
+const QFuture<Lexical::Data> NodeManager::readAsync(const Lexical::Data &p_dt) const {
+    return Async::call(&resolveNode, p_dt);
+}
+
+const QFuture<Lexical::Data> NodeManager::writeAsync(const Lexical::Data &p_dt) {
+    return Lexical::Cache::writeAsync(p_dt);
+}
+
+const QFuture<bool> NodeManager::existsAsync(const Lexical::Data &p_dt) const {
+    return Lexical::Cache::existsAsync(p_dt);
+}
+
 const Lexical::Data& NodeManager::write(const Lexical::Data &p_dt) {
     Lexical::Cache::write(p_dt);
     return p_dt;
 }
 
+const int NodeManager::writeBatch(const QList<Lexical::Data> &p_nodes, const int p_drblty) {
+    const int l_drblty = qBound((int) Lexical::Storage::DurabilityNone, p_drblty, (int) Lexical::Storage::DurabilitySync);
+    if (!Lexical::Cache::writeBatch(p_nodes, (Lexical::Storage::Durability) l_drblty))
+        return 0;
+
+    return p_nodes.count();
+}
+
 const bool NodeManager::exists(const Lexical::Data &p_dt) const {
     qDebug() << "(data) [NodeManager] Exists? " << p_dt.id() << Lexical::Cache::exists(p_dt);
     return Lexical::Cache::exists(p_dt);
@@ -82,13 +135,51 @@ const bool NodeManager::isPseudo(const Lexical::Data &p_dt) const {
     return Lexical::Cache::isPseudo(p_dt);
 }
 
+const QVariantMap NodeManager::statistics() const {
+    return Lexical::Cache::statistics();
+}
+
+const QStringList NodeManager::scanNodes(const QString& p_lcl, const QString& p_crsr, const int p_lmt) const {
+    return Lexical::Cache::scanNodes(p_lcl, p_crsr, p_lmt);
+}
+
+const QVariantMap NodeManager::prefixSearch(const QString& p_lcl, const QString& p_pfx, const int p_lmt) const {
+    return Lexical::Cache::prefixSearch(p_lcl, p_pfx, p_lmt);
+}
+
+const QVariantMap NodeManager::rangeSearch(const QString& p_lcl, const QString& p_frm, const QString& p_to, const int p_lmt) const {
+    return Lexical::Cache::rangeSearch(p_lcl, p_frm, p_to, p_lmt);
+}
+
+const QVariantList NodeManager::fuzzySearch(const QString& p_lcl, const QString& p_wrd, const int p_dist, const int p_lmt) const {
+    return Lexical::Cache::fuzzySearch(p_lcl, p_wrd, p_dist, p_lmt);
+}
+
+const QVariantMap NodeManager::linkSearch(const QString& p_lcl, const QString& p_code, const bool p_pfx, const int p_lmt) const {
+    return Lexical::Cache::linkSearch(p_lcl, p_code, p_pfx, p_lmt);
+}
+
+const QVariantMap NodeManager::linkCodes(const QString& p_lcl, const QString& p_pfx) const {
+    return Lexical::Cache::linkCodes(p_lcl, p_pfx);
+}
+
+const QStringList NodeManager::unloadIdle(const int p_idle) {
+    return Lexical::Cache::unloadIdle(p_idle);
+}
+
 NodeManager* NodeManager::instance() {
     if (!s_inst) s_inst = new NodeManager;
     return s_inst;
 }
 
-System::System() : m_dir(WNTRDATA_DATA_DIR) {
+System::System() : m_dir(WNTRDATA_DATA_DIR), m_wtchr(), m_rldTmr(), m_rldPool() {
+    m_rldTmr.setSingleShot (true);
+    m_rldTmr.setInterval (SYSTEM_RELOAD_DELAY);
+    m_rldPool.setMaxThreadCount (1);
+
     connect(this,SIGNAL(started()),this,SLOT(registerDataTypes()));
+    connect(&m_wtchr,SIGNAL(fileChanged(QString)),&m_rldTmr,SLOT(start()));
+    connect(&m_rldTmr,SIGNAL(timeout()),this,SLOT(reload()));
 }
 
 void System::registerDataTypes() {
@@ -105,12 +196,22 @@ void System::registerDataTypes() {
 
 void System::start ( ) {
     Linguistics::System::setLocale ( Core::arguments ()->value ("locale").toString () );
+    if ( Core::arguments ()->contains ("preload") )
+        Linguistics::System::setPreloads ( Core::arguments ()->value ("preload").toString ().split (",",QString::SkipEmptyParts) );
+
     Linguistics::System::load ( System::directory() + QString ( "/" ) + QString ( WNTRDATA_LING_DIR ) );
     Ontology::System::load();
+    s_inst->watch();
     emit s_inst->started();
 }
 
 void System::stop ( ) {
+    s_inst->m_rldTmr.stop ();
+    s_inst->m_rldPool.waitForDone ();
+    Linguistics::Async::pool ()->waitForDone ();
+    if (!s_inst->m_wtchr.files ().isEmpty ())
+        s_inst->m_wtchr.removePaths (s_inst->m_wtchr.files ());
+
     Wintermute::Data::Ontology::System::unload();
     Wintermute::Data::Linguistics::System::unload();
     emit s_inst->stopped();
@@ -121,9 +222,25 @@ const QString System::directory () {
 }
 
 void System::setDirectory(const QString& p_dir) {
-    stop();
     s_inst->m_dir = p_dir;
-    start();
+    s_inst->m_rldPool.start (new ReloadTask(p_dir + QString ( "/" ) + QString ( WNTRDATA_LING_DIR )));
+}
+
+void System::watch() {
+    if (!m_wtchr.files ().isEmpty ())
+        m_wtchr.removePaths (m_wtchr.files ());
+
+    // Files replaced by renaming drop out of the watcher, so they're all added anew.
+    foreach (const QString l_lcl, Linguistics::System::locales ()) {
+        const QString l_pth = Linguistics::System::directory () + QString ( "/" ) + l_lcl + QString ( "/node.xml" );
+        if (QFile::exists (l_pth))
+            m_wtchr.addPath (l_pth);
+    }
+}
+
+void System::reload() {
+    qDebug() << "(data) [System] The lexicon changed on disk; reloading it.";
+    m_rldPool.start (new ReloadTask);
 }
 
 System* System::instance () {
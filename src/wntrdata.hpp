@@ -51,6 +51,10 @@
 #ifndef __WNTRDATA_HPP__
 #define __WNTRDATA_HPP__
 
+#include <QTimer>
+#include <QThreadPool>
+#include <QFileSystemWatcher>
+#include <QtDBus/QDBusContext>
 #include "config.hpp"
 #include "ontology.hpp"
 #include "linguistics.hpp"
@@ -68,7 +72,8 @@ struct System;
 struct NodeManager;
 struct RuleManager;
 
-class NodeManager : public QObject {
+/// @note D-Bus attaches a call's context to the object an adaptor serves, so it's held here for NodeAdaptor.
+class NodeManager : public QObject, protected QDBusContext {
     friend class NodeAdaptor;
     friend class NodeInterface;
     Q_OBJECT
@@ -84,14 +89,30 @@ signals:
 public slots:
     void generate();
     Lexical::Data& pseudo(Lexical::Data& ) const;
-    Lexical::Data& read(Lexical::Data& ) const;
+    Lexical::Data& read(Lexical::Data&, const int = 0) const;
     const Lexical::Data& write(const Lexical::Data& );
+    const int writeBatch(const QList<Lexical::Data>&, const int = Lexical::Storage::DurabilityFlush);
     const bool exists(const Lexical::Data& ) const;
     const bool isPseudo(const Lexical::Data& ) const;
+    const QVariantMap statistics() const;
+    const QStringList scanNodes(const QString&, const QString&, const int) const;
+    const QVariantMap prefixSearch(const QString&, const QString&, const int) const;
+    const QVariantMap rangeSearch(const QString&, const QString&, const QString&, const int) const;
+    const QVariantList fuzzySearch(const QString&, const QString&, const int, const int) const;
+    const QVariantMap linkSearch(const QString&, const QString&, const bool, const int) const;
+    const QVariantMap linkCodes(const QString&, const QString&) const;
+    const QStringList unloadIdle(const int);
     static NodeManager* instance();
+
+public:
+    const QFuture<Lexical::Data> readAsync(const Lexical::Data& ) const;
+    const QFuture<Lexical::Data> writeAsync(const Lexical::Data& );
+    const QFuture<bool> existsAsync(const Lexical::Data& ) const;
 };
 
-class RuleManager : public QObject {
+/// @note D-Bus attaches a call's context to the object an adaptor serves, so it's held here for RuleAdaptor.
+class RuleManager : public QObject, protected QDBusContext {
+    friend class RuleAdaptor;
     Q_OBJECT
     Q_DISABLE_COPY(RuleManager)
 
@@ -104,6 +125,9 @@ public slots:
     void read(Rules::Chain& );
     void write(Rules::Chain& );
     const bool exists(const QString&, const QString& ) const;
+
+public:
+    const QFuture<Rules::Chain> readAsync(const Rules::Chain& ) const;
 };
 
 /**
@@ -119,6 +143,9 @@ class System : public QObject {
 private:
     static System* s_inst;
     QString m_dir;
+    QFileSystemWatcher m_wtchr; /**< Watches the node.xml of every locale. */
+    QTimer m_rldTmr; /**< Gathers a burst of changes to those into a single reload. */
+    QThreadPool m_rldPool; /**< Runs the reloads, one at a time. */
     System();
 
 public:
@@ -133,6 +160,8 @@ public:
      * @brief Changes the working directory.
      * @fn setDirectory
      * @param const QString
+     * @note The lexicon of the new directory's built in the background and
+     *       swapped in once it's ready; it's served from the old one till then.
      */
     static void setDirectory(const QString&);
 
@@ -172,6 +201,19 @@ public slots:
     static void start();
 
     static void registerDataTypes();
+
+private slots:
+    /**
+     * @brief Watches the node.xml of every locale, picking up any that were replaced.
+     * @fn watch
+     */
+    void watch();
+
+    /**
+     * @brief Queues a reload of the lexicon from the current directory.
+     * @fn reload
+     */
+    void reload();
 };
 
 class Plugin : public AbstractPlugin {